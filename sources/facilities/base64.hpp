@@ -0,0 +1,327 @@
+#ifndef LIBS_BASE64_HPP
+#define LIBS_BASE64_HPP
+
+#include <string>
+#include <string_view>
+#include <span>
+#include <array>
+#include <iostream>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+
+namespace hlibs::facilities::base64 {
+
+    /// url:https://datatracker.ietf.org/doc/html/rfc4648#section-4 (Standard) and #section-5 (URL: '-' and '_' instead of '+' and '/')
+    enum class Alphabet : int8_t {
+        Standard = 1,
+        URL = 2
+    };
+
+
+    [[maybe_unused]] static constexpr std::size_t EncodedSize(std::size_t bytes, bool padding = true) noexcept
+    {
+        return padding ? (bytes + 2) / 3 * 4 : bytes / 3 * 4 + (bytes % 3 == 0 ? 0 : bytes % 3 + 1);
+    }
+
+    /// The exact number of bytes encoded by the text (with or without padding), provided it is well-formed.
+    [[maybe_unused]] static constexpr std::size_t DecodedSize(std::string_view text) noexcept
+    {
+        std::size_t n = text.size();
+        if (n % 4 == 0 && n != 0 && text[n - 1] == '=') n -= text[n - 2] == '=' ? 2 : 1;
+        return n / 4 * 3 + (n % 4 == 0 ? 0 : n % 4 - 1);
+    }
+
+
+    /// Scalar tables; the decoding one maps characters outside the alphabet to -1.
+    struct Table {
+        static constexpr std::string_view standard = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+        static constexpr std::string_view url = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_";
+
+        static constexpr std::array<std::int8_t, 256> Inverse(std::string_view symbols) noexcept
+        {
+            std::array<std::int8_t, 256> values{};
+            values.fill(-1);
+            for (std::size_t i = 0; i != symbols.size(); ++i) values[static_cast<unsigned char>(symbols[i])] = static_cast<std::int8_t>(i);
+            return values;
+        }
+
+        static std::string_view Symbols(Alphabet alphabet) noexcept
+        {
+            return alphabet == Alphabet::URL ? url : standard;
+        }
+
+        static const std::array<std::int8_t, 256>& Values(Alphabet alphabet) noexcept
+        {
+            static constexpr auto standard_values = Inverse(standard);
+            static constexpr auto url_values = Inverse(url);
+            return alphabet == Alphabet::URL ? url_values : standard_values;
+        }
+    };
+
+
+#if defined(__x86_64__)
+    /// Encodes 12 bytes (loading 16) into 16 characters per step; returns the number of input bytes consumed.
+    /// url:http://0x80.pl/notesen/2016-01-12-sse-base64-encoding.html
+    __attribute__((target("ssse3"))) static std::size_t EncodeSSSE3(const char* in, std::size_t n, char* out, Alphabet alphabet) noexcept
+    {
+        const char plus = alphabet == Alphabet::URL ? '-' : '+';
+        const char slash = alphabet == Alphabet::URL ? '_' : '/';
+        const __m128i shuffle = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+        const __m128i shift = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                            '0' - 52, static_cast<char>(plus - 62), static_cast<char>(slash - 63), 'A', 0, 0);
+        std::size_t i = 0;
+
+        for (; n - i >= 16; i += 12, out += 16) {
+            __m128i bytes = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), shuffle);
+            __m128i high = _mm_mulhi_epu16(_mm_and_si128(bytes, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+            __m128i low = _mm_mullo_epi16(_mm_and_si128(bytes, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+            __m128i indices = _mm_or_si128(high, low);
+            __m128i rank = _mm_subs_epu8(indices, _mm_set1_epi8(51));
+            rank = _mm_or_si128(rank, _mm_and_si128(_mm_cmpgt_epi8(_mm_set1_epi8(26), indices), _mm_set1_epi8(13)));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_add_epi8(_mm_shuffle_epi8(shift, rank), indices));
+        }
+
+        return i;
+    }
+
+    /// Decodes 16 characters into 12 bytes (storing 16) per step, up to the first character outside the alphabet;
+    /// returns the number of characters consumed.
+    /// url:http://0x80.pl/notesen/2016-01-17-sse-base64-decoding.html
+    __attribute__((target("ssse3"))) static std::size_t DecodeSSSE3(const char* in, std::size_t n, char* out, Alphabet alphabet) noexcept
+    {
+        const __m128i low_lookup = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+        const __m128i high_lookup = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+        const __m128i roll_lookup = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+        const __m128i mask_2F = _mm_set1_epi8(0x2F);
+        const __m128i pack = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+        const __m128i zero = _mm_setzero_si128();
+        std::size_t i = 0;
+
+        for (; n - i >= 16; i += 16, out += 12) {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i));
+
+            if (alphabet == Alphabet::URL) {
+                // '+' and '/' become 0 (rejected below), while '-' and '_' take their place
+                __m128i foreign = _mm_or_si128(_mm_cmpeq_epi8(chars, _mm_set1_epi8('+')), _mm_cmpeq_epi8(chars, _mm_set1_epi8('/')));
+                __m128i minus = _mm_cmpeq_epi8(chars, _mm_set1_epi8('-'));
+                __m128i underscore = _mm_cmpeq_epi8(chars, _mm_set1_epi8('_'));
+                chars = _mm_andnot_si128(_mm_or_si128(foreign, _mm_or_si128(minus, underscore)), chars);
+                chars = _mm_or_si128(chars, _mm_or_si128(_mm_and_si128(minus, _mm_set1_epi8('+')), _mm_and_si128(underscore, mask_2F)));
+            }
+
+            __m128i high_nibbles = _mm_and_si128(_mm_srli_epi32(chars, 4), mask_2F);
+            __m128i low = _mm_shuffle_epi8(low_lookup, _mm_and_si128(chars, mask_2F));
+            __m128i high = _mm_shuffle_epi8(high_lookup, high_nibbles);
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(low, high), zero)) != 0xFFFF) break;
+
+            __m128i roll = _mm_shuffle_epi8(roll_lookup, _mm_add_epi8(_mm_cmpeq_epi8(chars, mask_2F), high_nibbles));
+            __m128i values = _mm_add_epi8(chars, roll);
+            __m128i merged = _mm_madd_epi16(_mm_maddubs_epi16(values, _mm_set1_epi32(0x01400140)), _mm_set1_epi32(0x00011000));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm_shuffle_epi8(merged, pack));
+        }
+
+        return i;
+    }
+#endif
+
+    [[maybe_unused]] static bool IsAccelerated() noexcept
+    {
+#if defined(__x86_64__)
+        static const bool hasSSSE3 = __builtin_cpu_supports("ssse3");
+        return hasSSSE3;
+#else
+        return false;
+#endif
+    }
+
+
+    /// Writes EncodedSize(bytes.size(), padding) characters into the target; returns their number.
+    [[maybe_unused]] static std::size_t Encode(std::string_view bytes, std::span<char> target, Alphabet alphabet = Alphabet::Standard, bool padding = true)
+    {
+        const std::size_t size = EncodedSize(bytes.size(), padding);
+        if (target.size() < size) throw std::length_error("target.size() < EncodedSize()");
+
+        const auto symbols = Table::Symbols(alphabet);
+        const auto* in = reinterpret_cast<const unsigned char*>(bytes.data());
+        const std::size_t n = bytes.size();
+        char* out = target.data();
+        std::size_t i = 0;
+
+#if defined(__x86_64__)
+        if (IsAccelerated()) {
+            i = EncodeSSSE3(bytes.data(), n, out, alphabet);
+            out += i / 3 * 4;
+        }
+#endif
+
+        for (; n - i >= 3; i += 3, out += 4) {
+            std::uint32_t triple = (in[i] << 16U) | (in[i + 1] << 8U) | in[i + 2];
+            out[0] = symbols[triple >> 18];
+            out[1] = symbols[(triple >> 12) & 0x3F];
+            out[2] = symbols[(triple >> 6) & 0x3F];
+            out[3] = symbols[triple & 0x3F];
+        }
+
+        if (n - i == 1) {
+            *out++ = symbols[in[i] >> 2];
+            *out++ = symbols[(in[i] & 0x03) << 4];
+            if (padding) {
+                *out++ = '=';
+                *out++ = '=';
+            }
+        }
+        else if (n - i == 2) {
+            *out++ = symbols[in[i] >> 2];
+            *out++ = symbols[((in[i] & 0x03) << 4) | (in[i + 1] >> 4)];
+            *out++ = symbols[(in[i + 1] & 0x0F) << 2];
+            if (padding) *out++ = '=';
+        }
+
+        return size;
+    }
+
+    [[maybe_unused]] static std::string Encode(std::string_view bytes, Alphabet alphabet = Alphabet::Standard, bool padding = true)
+    {
+        std::string text(EncodedSize(bytes.size(), padding), '\0');
+        Encode(bytes, text, alphabet, padding);
+        return text;
+    }
+
+    /// Writes DecodedSize(text) bytes into the target; returns their number. Padding is optional, while characters
+    /// outside the alphabet (including white space) and impossible lengths throw.
+    [[maybe_unused]] static std::size_t Decode(std::string_view text, std::span<char> target, Alphabet alphabet = Alphabet::Standard)
+    {
+        const std::size_t size = DecodedSize(text);
+        if (target.size() < size) throw std::length_error("target.size() < DecodedSize()");
+
+        std::size_t n = text.size();
+        if (n % 4 == 0 && n != 0 && text[n - 1] == '=') n -= text[n - 2] == '=' ? 2 : 1;
+        if (n % 4 == 1) throw std::invalid_argument("text.size() % 4 == 1");
+
+        const auto& values = Table::Values(alphabet);
+        char* out = target.data();
+        std::size_t i = 0;
+
+#if defined(__x86_64__)
+        // k blocks store 12 * (k - 1) + 16 bytes, which must fit the target; the tail is left to the scalar loop
+        if (IsAccelerated() && n >= 20 && target.size() >= 16) {
+            i = DecodeSSSE3(text.data(), std::min(n - 4, (target.size() - 4) / 12 * 16), out, alphabet);
+            out += i / 4 * 3;
+        }
+#endif
+
+        const auto value = [&values, &text](std::size_t at) {
+            auto v = values[static_cast<unsigned char>(text[at])];
+            if (v < 0) throw std::invalid_argument("!isInAlphabet(text[" + std::to_string(at) + "])");
+            return static_cast<std::uint32_t>(v);
+        };
+
+        for (; n - i >= 4; i += 4, out += 3) {
+            std::uint32_t quad = (value(i) << 18) | (value(i + 1) << 12) | (value(i + 2) << 6) | value(i + 3);
+            out[0] = static_cast<char>(quad >> 16);
+            out[1] = static_cast<char>((quad >> 8) & 0xFF);
+            out[2] = static_cast<char>(quad & 0xFF);
+        }
+
+        if (n - i >= 2) {
+            std::uint32_t quad = (value(i) << 18) | (value(i + 1) << 12) | (n - i == 3 ? value(i + 2) << 6 : 0);
+            *out++ = static_cast<char>(quad >> 16);
+            if (n - i == 3) *out++ = static_cast<char>((quad >> 8) & 0xFF);
+        }
+
+        return size;
+    }
+
+    [[maybe_unused]] static std::string Decode(std::string_view text, Alphabet alphabet = Alphabet::Standard)
+    {
+        std::string bytes(DecodedSize(text), '\0');
+        Decode(text, bytes, alphabet);
+        return bytes;
+    }
+
+
+    /// Encodes a stream of bytes given piece by piece into any sink with write(std::string_view), such as io::FileWriter.
+    /// Characters are handed over in chunks; the padding follows finish() (called on destruction as well).
+    template<typename Sink>
+    class Encoder final {
+      public:
+        explicit Encoder(Sink& destination, Alphabet symbols = Alphabet::Standard, bool padded = true)
+                : sink(destination), alphabet(symbols), padding(padded)
+        {
+        }
+
+        Encoder(const Encoder& rhs) = delete;
+        Encoder& operator=(const Encoder& rhs) = delete;
+
+        ~Encoder() noexcept
+        {
+            try {
+                finish();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "~Encoder->exception: " << e.what();
+            }
+        }
+
+        void update(std::string_view bytes)
+        {
+            while (pending_size != 0 && pending_size != 3 && !bytes.empty()) {
+                pending[pending_size++] = bytes.front();
+                bytes.remove_prefix(1);
+            }
+
+            if (pending_size == 3) {
+                emit(std::string_view(pending.data(), 3));
+                pending_size = 0;
+            }
+
+            while (bytes.size() >= 3) {
+                auto whole = std::min(bytes.size() / 3 * 3, chunk.size() / 4 * 3);
+                emit(bytes.substr(0, whole));
+                bytes.remove_prefix(whole);
+            }
+
+            std::memcpy(pending.data() + pending_size, bytes.data(), bytes.size());
+            pending_size += bytes.size();
+        }
+
+        /// Encodes the last one or two bytes; the encoder may be used for a new text afterwards.
+        void finish()
+        {
+            if (pending_size != 0) emit(std::string_view(pending.data(), pending_size));
+            pending_size = 0;
+        }
+
+        /// The number of characters handed over to the sink.
+        inline std::size_t size() const noexcept
+        {
+            return written;
+        }
+
+      private:
+        void emit(std::string_view bytes)
+        {
+            auto n = Encode(bytes, chunk, alphabet, padding);
+            sink.write(std::string_view(chunk.data(), n));
+            written += n;
+        }
+
+        Sink& sink;
+        Alphabet alphabet;
+        bool padding;
+        std::array<char, 3> pending{};
+        std::size_t pending_size = 0;
+        std::size_t written = 0;
+        std::array<char, 4096> chunk{};
+    };
+
+}
+
+#endif //LIBS_BASE64_HPP
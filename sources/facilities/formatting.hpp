@@ -0,0 +1,225 @@
+#ifndef LIBS_FORMATTING_HPP
+#define LIBS_FORMATTING_HPP
+
+#include <string>
+#include <string_view>
+#include <charconv>
+#include <concepts>
+#include <type_traits>
+#include <memory_resource>
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <span>
+#include <limits>
+
+
+namespace hlibs::facilities::formatting {
+
+    /// Per-thread pool of blocks that builders spill into; blocks are recycled, so after warming up the general-purpose
+    /// allocator is no longer asked for memory.
+    [[maybe_unused]] static std::pmr::memory_resource* ThreadArena() noexcept
+    {
+        thread_local std::pmr::unsynchronized_pool_resource arena;
+        return &arena;
+    }
+
+
+    /// Builds text in an inline buffer of Capacity bytes and continues in the arena once it is full. It cannot be copied or
+    /// moved, so it lives on the stack of the thread that owns its arena: format into it, then take view() or str().
+    template<std::size_t Capacity = 256>
+    class StringBuilder final {
+      public:
+        explicit StringBuilder(std::pmr::memory_resource* resource = ThreadArena()) noexcept: arena(resource)
+        {
+        }
+
+        StringBuilder(const StringBuilder& rhs) = delete;
+        StringBuilder& operator=(const StringBuilder& rhs) = delete;
+
+        StringBuilder(StringBuilder&& rhs) noexcept = delete;
+        StringBuilder& operator=(StringBuilder&& rhs) noexcept = delete;
+
+        ~StringBuilder() noexcept
+        {
+            if (!isInline()) arena->deallocate(buffer, limit, 1);
+        }
+
+        StringBuilder& append(std::string_view text)
+        {
+            if (!text.empty()) std::memcpy(extend(text.size()).data(), text.data(), text.size());
+            return *this;
+        }
+
+        StringBuilder& append(char ch)
+        {
+            extend(1).front() = ch;
+            return *this;
+        }
+
+        /// Signed and unsigned characters (such as std::int8_t) are put as characters, as std::ostream does.
+        StringBuilder& append(signed char ch)
+        {
+            return append(static_cast<char>(ch));
+        }
+
+        StringBuilder& append(unsigned char ch)
+        {
+            return append(static_cast<char>(ch));
+        }
+
+        /// "1" or "0", as std::ostream prints it without boolalpha.
+        StringBuilder& append(bool value)
+        {
+            return append(value ? '1' : '0');
+        }
+
+        StringBuilder& appendRepeated(char ch, std::size_t count)
+        {
+            if (count != 0) std::memset(extend(count).data(), ch, count);
+            return *this;
+        }
+
+        StringBuilder& append(const char* text)
+        {
+            return append(std::string_view(text));
+        }
+
+        template<std::integral T> requires (!std::is_same_v<T, bool> && !std::is_same_v<T, char> && !std::is_same_v<T, signed char> && !std::is_same_v<T, unsigned char>)
+        StringBuilder& append(T value, int base = 10)
+        {
+            return convert(sizeof(T) * 8 + 1, [&](char* first, char* last) { return std::to_chars(first, last, value, base); });
+        }
+
+        /// The shortest text that reads back as the same value.
+        template<std::floating_point T>
+        StringBuilder& append(T value)
+        {
+            return convert(64, [&](char* first, char* last) { return std::to_chars(first, last, value); });
+        }
+
+        template<std::floating_point T>
+        StringBuilder& append(T value, std::chars_format format, int precision)
+        {
+            auto room = static_cast<std::size_t>(std::max(precision, 0) + std::numeric_limits<T>::max_exponent10 + 16);
+            return convert(room, [&](char* first, char* last) { return std::to_chars(first, last, value, format, precision); });
+        }
+
+        /// "0x" and the address in hexadecimal, as std::ostream prints it.
+        StringBuilder& append(const void* pointer)
+        {
+            if (pointer == nullptr) return append('0');
+            return append("0x").append(reinterpret_cast<std::uintptr_t>(pointer), 16);
+        }
+
+        /// Between double quotes, with '"' and '\' escaped by a backslash (as std::quoted writes it).
+        StringBuilder& appendQuoted(std::string_view text)
+        {
+            append('"');
+
+            for (auto at = text.find_first_of("\"\\"); at != std::string_view::npos; at = text.find_first_of("\"\\")) {
+                append(text.substr(0, at)).append('\\').append(text[at]);
+                text.remove_prefix(at + 1);
+            }
+
+            return append(text).append('"');
+        }
+
+        template<typename T>
+        StringBuilder& operator<<(const T& value)
+        {
+            return append(value);
+        }
+
+        /// The space for count more characters, to be written by the caller (such as a converter or ToUpperCaseInPlace).
+        std::span<char> extend(std::size_t count)
+        {
+            if (limit - used < count) grow(used + count);
+            auto* free = buffer + used;
+            used += count;
+            return {free, count};
+        }
+
+        void clear() noexcept
+        {
+            used = 0;
+        }
+
+        void reserve(std::size_t capacity)
+        {
+            if (capacity > limit) grow(capacity);
+        }
+
+        /// Drops the last count characters.
+        void shrink(std::size_t count) noexcept
+        {
+            used -= std::min(count, used);
+        }
+
+        [[nodiscard]] std::string_view view() const noexcept
+        {
+            return {buffer, used};
+        }
+
+        [[nodiscard]] std::string str() const
+        {
+            return std::string(view());
+        }
+
+        inline const char* data() const noexcept
+        {
+            return buffer;
+        }
+
+        inline std::size_t size() const noexcept
+        {
+            return used;
+        }
+
+        inline std::size_t capacity() const noexcept
+        {
+            return limit;
+        }
+
+        inline bool isInline() const noexcept
+        {
+            return buffer == local;
+        }
+
+      private:
+        /// Lets the converter write into the free space at the end and keeps as many characters as it has written; only if
+        /// they do not fit, grows to the worst case of room characters and converts again.
+        template<typename F>
+        StringBuilder& convert(std::size_t room, F&& converter)
+        {
+            if (auto [end, ec] = converter(buffer + used, buffer + limit); ec == std::errc()) {
+                used = static_cast<std::size_t>(end - buffer);
+                return *this;
+            }
+
+            auto space = extend(room);
+            auto [end, ec] = converter(space.data(), space.data() + space.size());
+            shrink(ec == std::errc() ? static_cast<std::size_t>(space.data() + space.size() - end) : room);
+            return *this;
+        }
+
+        void grow(std::size_t needed)
+        {
+            auto capacity = std::max(limit * 2, needed);
+            auto* larger = static_cast<char*>(arena->allocate(capacity, 1));
+            std::memcpy(larger, buffer, used);
+            if (!isInline()) arena->deallocate(buffer, limit, 1);
+            buffer = larger;
+            limit = capacity;
+        }
+
+        std::pmr::memory_resource* arena;
+        char local[Capacity];
+        char* buffer = local;
+        std::size_t used = 0;
+        std::size_t limit = Capacity;
+    };
+
+}
+
+#endif //LIBS_FORMATTING_HPP
@@ -0,0 +1,339 @@
+#ifndef LIBS_HASHING_HPP
+#define LIBS_HASHING_HPP
+
+#include <string_view>
+#include <streambuf>
+#include <iostream>
+#include <array>
+#include <vector>
+#include <cstdint>
+#include <cstring>
+#include <concepts>
+#include <algorithm>
+
+#if defined(__x86_64__)
+#include <nmmintrin.h>
+#endif
+
+
+namespace hlibs::facilities::hashing {
+
+    /// Anything fed incrementally with bytes, such as CRC32C or Hash64.
+    template<typename T>
+    concept Checksum = requires(T checksum, std::string_view bytes) {
+        checksum.update(bytes);
+        checksum.value();
+    };
+
+
+    /// Slicing-by-8 tables of the reflected Castagnoli polynomial.
+    [[maybe_unused]] static constexpr std::array<std::array<std::uint32_t, 256>, 8> MakeCRC32CTables() noexcept
+    {
+        constexpr std::uint32_t polynomial = 0x82F63B78U;
+        std::array<std::array<std::uint32_t, 256>, 8> result{};
+
+        for (std::uint32_t i = 0; i != 256; ++i) {
+            std::uint32_t crc = i;
+            for (int bit = 0; bit != 8; ++bit) crc = (crc & 1U) ? (crc >> 1) ^ polynomial : crc >> 1;
+            result[0][i] = crc;
+        }
+
+        for (std::size_t t = 1; t != result.size(); ++t) {
+            for (std::size_t i = 0; i != 256; ++i) result[t][i] = (result[t - 1][i] >> 8) ^ result[0][result[t - 1][i] & 0xFF];
+        }
+
+        return result;
+    }
+
+
+    /// CRC-32C (Castagnoli), with the SSE4.2 crc32 instruction when the CPU has it and slicing-by-8 tables otherwise.
+    /// url:https://datatracker.ietf.org/doc/html/rfc3720#appendix-B.4
+    class CRC32C final {
+      public:
+        void update(const void* data, std::size_t size) noexcept
+        {
+            const auto* bytes = static_cast<const unsigned char*>(data);
+            state = IsAccelerated() ? Hardware(state, bytes, size) : Software(state, bytes, size);
+        }
+
+        void update(std::string_view bytes) noexcept
+        {
+            update(bytes.data(), bytes.size());
+        }
+
+        inline std::uint32_t value() const noexcept
+        {
+            return ~state;
+        }
+
+        inline void reset() noexcept
+        {
+            state = ~0U;
+        }
+
+        static std::uint32_t Of(std::string_view bytes) noexcept
+        {
+            CRC32C crc;
+            crc.update(bytes);
+            return crc.value();
+        }
+
+        static bool IsAccelerated() noexcept
+        {
+#if defined(__x86_64__)
+            static const bool hasSSE42 = __builtin_cpu_supports("sse4.2");
+            return hasSSE42;
+#else
+            return false;
+#endif
+        }
+
+        /// The table-driven path, also usable where the instruction exists (e.g. to cross-check it).
+        static std::uint32_t Software(std::uint32_t crc, const unsigned char* p, std::size_t n) noexcept
+        {
+            for (; n >= 8; p += 8, n -= 8) {
+                std::uint32_t low;
+                std::uint32_t high;
+                std::memcpy(&low, p, 4);
+                std::memcpy(&high, p + 4, 4);
+                low ^= crc;
+                crc = tables[7][low & 0xFF] ^ tables[6][(low >> 8) & 0xFF] ^ tables[5][(low >> 16) & 0xFF] ^ tables[4][low >> 24] ^
+                      tables[3][high & 0xFF] ^ tables[2][(high >> 8) & 0xFF] ^ tables[1][(high >> 16) & 0xFF] ^ tables[0][high >> 24];
+            }
+
+            while (n-- != 0) crc = tables[0][(crc ^ *p++) & 0xFF] ^ (crc >> 8);
+            return crc;
+        }
+
+      private:
+#if defined(__x86_64__)
+        __attribute__((target("sse4.2"))) static std::uint32_t Hardware(std::uint32_t crc, const unsigned char* p, std::size_t n) noexcept
+        {
+            std::uint64_t wide = crc;
+
+            for (; n >= 8; p += 8, n -= 8) {
+                std::uint64_t word;
+                std::memcpy(&word, p, 8);
+                wide = _mm_crc32_u64(wide, word);
+            }
+
+            crc = static_cast<std::uint32_t>(wide);
+            while (n-- != 0) crc = _mm_crc32_u8(crc, *p++);
+            return crc;
+        }
+#else
+        static std::uint32_t Hardware(std::uint32_t crc, const unsigned char* p, std::size_t n) noexcept
+        {
+            return Software(crc, p, n);
+        }
+#endif
+
+        static constexpr auto tables = MakeCRC32CTables();
+
+        std::uint32_t state = ~0U;
+    };
+
+
+    /// Fast 64-bit non-cryptographic hash, computing the XXH64 algorithm incrementally.
+    /// url:https://github.com/Cyan4973/xxHash/blob/dev/doc/xxhash_spec.md
+    class Hash64 final {
+      public:
+        explicit Hash64(std::uint64_t seed = 0) noexcept: initial(seed)
+        {
+            reset();
+        }
+
+        void update(const void* data, std::size_t size) noexcept
+        {
+            const auto* p = static_cast<const unsigned char*>(data);
+            total += size;
+
+            if (buffered + size < stripe) {
+                std::memcpy(buffer.data() + buffered, p, size);
+                buffered += size;
+                return;
+            }
+
+            if (buffered != 0) {
+                auto fill = stripe - buffered;
+                std::memcpy(buffer.data() + buffered, p, fill);
+                consume(buffer.data());
+                p += fill;
+                size -= fill;
+                buffered = 0;
+            }
+
+            for (; size >= stripe; p += stripe, size -= stripe) consume(p);
+
+            std::memcpy(buffer.data(), p, size);
+            buffered = size;
+        }
+
+        void update(std::string_view bytes) noexcept
+        {
+            update(bytes.data(), bytes.size());
+        }
+
+        std::uint64_t value() const noexcept
+        {
+            std::uint64_t h = total >= stripe ? Merge(Merge(Merge(Merge(Rotate(v[0], 1) + Rotate(v[1], 7) + Rotate(v[2], 12) + Rotate(v[3], 18),
+                                                                      v[0]), v[1]), v[2]), v[3])
+                                              : initial + prime5;
+            h += total;
+
+            const unsigned char* p = buffer.data();
+            std::size_t n = buffered;
+
+            for (; n >= 8; p += 8, n -= 8) {
+                h ^= Round(0, Read64(p));
+                h = Rotate(h, 27) * prime1 + prime4;
+            }
+
+            if (n >= 4) {
+                std::uint32_t word;
+                std::memcpy(&word, p, 4);
+                h ^= word * prime1;
+                h = Rotate(h, 23) * prime2 + prime3;
+                p += 4;
+                n -= 4;
+            }
+
+            for (; n != 0; ++p, --n) {
+                h ^= *p * prime5;
+                h = Rotate(h, 11) * prime1;
+            }
+
+            h ^= h >> 33;
+            h *= prime2;
+            h ^= h >> 29;
+            h *= prime3;
+            h ^= h >> 32;
+            return h;
+        }
+
+        void reset() noexcept
+        {
+            v = {initial + prime1 + prime2, initial + prime2, initial, initial - prime1};
+            total = 0;
+            buffered = 0;
+        }
+
+        static std::uint64_t Of(std::string_view bytes, std::uint64_t seed = 0) noexcept
+        {
+            Hash64 hash(seed);
+            hash.update(bytes);
+            return hash.value();
+        }
+
+      private:
+        static constexpr std::uint64_t prime1 = 0x9E3779B185EBCA87ULL;
+        static constexpr std::uint64_t prime2 = 0xC2B2AE3D27D4EB4FULL;
+        static constexpr std::uint64_t prime3 = 0x165667B19E3779F9ULL;
+        static constexpr std::uint64_t prime4 = 0x85EBCA77C2B2AE63ULL;
+        static constexpr std::uint64_t prime5 = 0x27D4EB2F165667C5ULL;
+        static constexpr std::size_t stripe = 32;
+
+        static std::uint64_t Rotate(std::uint64_t x, int bits) noexcept
+        {
+            return (x << bits) | (x >> (64 - bits));
+        }
+
+        static std::uint64_t Read64(const unsigned char* p) noexcept
+        {
+            std::uint64_t word;
+            std::memcpy(&word, p, 8);
+            return word;
+        }
+
+        static std::uint64_t Round(std::uint64_t accumulator, std::uint64_t input) noexcept
+        {
+            accumulator += input * prime2;
+            return Rotate(accumulator, 31) * prime1;
+        }
+
+        static std::uint64_t Merge(std::uint64_t h, std::uint64_t accumulator) noexcept
+        {
+            h ^= Round(0, accumulator);
+            return h * prime1 + prime4;
+        }
+
+        void consume(const unsigned char* p) noexcept
+        {
+            for (std::size_t lane = 0; lane != v.size(); ++lane) v[lane] = Round(v[lane], Read64(p + 8 * lane));
+        }
+
+        std::uint64_t initial;
+        std::array<std::uint64_t, 4> v{};
+        std::array<unsigned char, stripe> buffer{};
+        std::size_t buffered = 0;
+        std::uint64_t total = 0;
+    };
+
+
+    /// Stream filter feeding the checksum with every byte passing through it, in one direction or the other. Output is
+    /// handed to the next buffer in chunks, so the checksum covers the bytes written before each sync.
+    template<Checksum T>
+    class ChecksumBuffer final : public std::streambuf {
+      public:
+        ChecksumBuffer(std::streambuf* neighbour, T& checksum, std::size_t capacity = 1UL << 14)
+                : next(neighbour), sum(checksum), chunk(std::max<std::size_t>(capacity, 1))
+        {
+            setp(chunk.data(), chunk.data() + chunk.size());
+        }
+
+        ChecksumBuffer(const ChecksumBuffer& rhs) = delete;
+        ChecksumBuffer& operator=(const ChecksumBuffer& rhs) = delete;
+
+        ~ChecksumBuffer() noexcept override
+        {
+            try {
+                forward();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "~ChecksumBuffer->exception: " << e.what();
+            }
+        }
+
+      protected:
+        int_type overflow(int_type ch) override
+        {
+            forward();
+            if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+            return ch;
+        }
+
+        int sync() override
+        {
+            forward();
+            return next->pubsync();
+        }
+
+        int_type underflow() override
+        {
+            auto n = next->sgetn(chunk.data(), static_cast<std::streamsize>(chunk.size()));
+            if (n <= 0) return traits_type::eof();
+            sum.update(std::string_view(chunk.data(), static_cast<std::size_t>(n)));
+            setg(chunk.data(), chunk.data(), chunk.data() + n);
+            return traits_type::to_int_type(*gptr());
+        }
+
+      private:
+        void forward()
+        {
+            auto size = pptr() - pbase();
+            if (size == 0) return;
+            sum.update(std::string_view(pbase(), static_cast<std::size_t>(size)));
+            if (next->sputn(pbase(), size) != size) throw std::ios_base::failure("sputn() != size");
+            setp(chunk.data(), chunk.data() + chunk.size());
+        }
+
+        std::streambuf* next;
+        T& sum;
+        std::vector<char> chunk;
+    };
+
+}
+
+#endif //LIBS_HASHING_HPP
@@ -0,0 +1,230 @@
+#ifndef LIBS_INTERNING_HPP
+#define LIBS_INTERNING_HPP
+
+#include <string_view>
+#include <vector>
+#include <array>
+#include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <atomic>
+#include <optional>
+#include <unordered_map>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <experimental/source_location>
+
+
+namespace hlibs::facilities::interning {
+
+    /// Handle of an interned string: equal strings get equal IDs within a pool.
+    using ID = std::uint32_t;
+
+
+    /// Keeps a single copy of every string given to it, in chunks of memory that are never moved or freed before the pool,
+    /// so the views it returns stay valid for its whole lifetime. It is split into shards by hash, each with its own lock;
+    /// looking up a string that is already there is a hash probe under a shared lock.
+    class StringPool final {
+      public:
+        explicit StringPool(std::size_t chunk_size = 1UL << 12): chunk(std::max<std::size_t>(chunk_size, 64))
+        {
+        }
+
+        StringPool(const StringPool& rhs) = delete;
+        StringPool& operator=(const StringPool& rhs) = delete;
+
+        StringPool(StringPool&& rhs) noexcept = delete;
+        StringPool& operator=(StringPool&& rhs) noexcept = delete;
+
+        ~StringPool() noexcept = default;
+
+        /// The pool shared by the loggers (and anyone else).
+        static StringPool& Global()
+        {
+            static StringPool pool;
+            return pool;
+        }
+
+        ID intern(std::string_view text)
+        {
+            const auto hash = std::hash<std::string_view>{}(text);
+            auto& shard = shards[hash % Shards];
+
+            {
+                std::shared_lock lock(shard.mutex);
+                if (auto local = shard.find(text, hash)) return Compose(hash % Shards, *local);
+            }
+
+            std::unique_lock lock(shard.mutex);
+            if (auto local = shard.find(text, hash)) return Compose(hash % Shards, *local);
+
+            if (shard.views.size() >= (1UL << (32 - ShardBits)) - 1) throw std::length_error("views.size() >= capacity");
+            auto local = static_cast<ID>(shard.views.size());
+            shard.views.push_back(shard.store(text, chunk));
+            shard.insert(hash, local);
+            bytes_stored.fetch_add(text.size(), std::memory_order_relaxed);
+            return Compose(hash % Shards, local);
+        }
+
+        /// The ID of the text, if it has been interned (nothing is added).
+        [[nodiscard]] std::optional<ID> find(std::string_view text) const
+        {
+            const auto hash = std::hash<std::string_view>{}(text);
+            const auto& shard = shards[hash % Shards];
+            std::shared_lock lock(shard.mutex);
+            auto local = shard.find(text, hash);
+            return local ? std::optional<ID>(Compose(hash % Shards, *local)) : std::nullopt;
+        }
+
+        /// The interned text (valid as long as the pool); the ID has to come from this pool.
+        std::string_view view(ID id) const
+        {
+            const auto& shard = shards[id & (Shards - 1)];
+            std::shared_lock lock(shard.mutex);
+            return shard.views.at(id >> ShardBits);
+        }
+
+        /// Interns the text and returns its stored copy.
+        std::string_view operator()(std::string_view text)
+        {
+            return view(intern(text));
+        }
+
+        std::size_t size() const
+        {
+            std::size_t count = 0;
+
+            for (const auto& shard : shards) {
+                std::shared_lock lock(shard.mutex);
+                count += shard.views.size();
+            }
+
+            return count;
+        }
+
+        /// Bytes of the interned strings (not counting the unused ends of chunks).
+        inline std::size_t bytes() const noexcept
+        {
+            return bytes_stored.load(std::memory_order_relaxed);
+        }
+
+      private:
+        static constexpr std::size_t ShardBits = 4;
+        static constexpr std::size_t Shards = 1UL << ShardBits;
+
+        struct Shard {
+            /// Open addressing with linear probing; a slot holds the hash and local ID + 1 (0 for an empty slot).
+            struct Slot {
+                std::size_t hash = 0;
+                ID entry = 0;
+            };
+
+            std::optional<ID> find(std::string_view text, std::size_t hash) const noexcept
+            {
+                if (slots.empty()) return std::nullopt;
+
+                for (auto i = hash & (slots.size() - 1);; i = (i + 1) & (slots.size() - 1)) {
+                    const auto& slot = slots[i];
+                    if (slot.entry == 0) return std::nullopt;
+                    if (slot.hash == hash && views[slot.entry - 1] == text) return slot.entry - 1;
+                }
+            }
+
+            void insert(std::size_t hash, ID local)
+            {
+                if ((views.size() + 1) * 2 > slots.size()) {
+                    std::vector<Slot> old(std::max<std::size_t>(slots.size() * 2, 16));
+                    old.swap(slots);
+                    for (const auto& slot : old) {
+                        if (slot.entry != 0) place(slot);
+                    }
+                }
+
+                place(Slot{hash, local + 1});
+            }
+
+            void place(Slot slot) noexcept
+            {
+                auto i = slot.hash & (slots.size() - 1);
+                while (slots[i].entry != 0) i = (i + 1) & (slots.size() - 1);
+                slots[i] = slot;
+            }
+
+            /// Copies the text to the arena: the current chunk if it fits, a new one otherwise (of its own size, if larger).
+            std::string_view store(std::string_view text, std::size_t chunk_size)
+            {
+                if (text.empty()) return {};
+
+                if (arena.empty() || chunk_size - used < text.size()) {
+                    arena.push_back(std::make_unique<char[]>(std::max(chunk_size, text.size())));
+                    used = 0;
+                }
+
+                char* target = arena.back().get() + used;
+                std::memcpy(target, text.data(), text.size());
+                used = text.size() > chunk_size ? chunk_size : used + text.size();
+                return {target, text.size()};
+            }
+
+            mutable std::shared_mutex mutex;
+            std::vector<Slot> slots{};
+            std::vector<std::string_view> views{};
+            std::vector<std::unique_ptr<char[]>> arena{};
+            std::size_t used = 0;
+        };
+
+        static constexpr ID Compose(std::size_t shard, ID local) noexcept
+        {
+            return (local << ShardBits) | static_cast<ID>(shard);
+        }
+
+        std::size_t chunk;
+        std::array<Shard, Shards> shards{};
+        std::atomic<std::size_t> bytes_stored = 0;
+    };
+
+
+    /// Parts of a call site as interned strings.
+    struct Site {
+        std::string_view file;        ///< base name of the source file
+        std::string_view function;
+    };
+
+    /// Interns the parts of the call site in the global pool. The result is cached per thread by the addresses of the
+    /// (static) strings of the source_location, so a repeated call site costs a hash probe without locking or allocating.
+    [[maybe_unused]] static const Site& SiteOf(const std::experimental::source_location& location)
+    {
+        struct Key {
+            const char* file;
+            const char* function;
+
+            bool operator==(const Key& rhs) const noexcept = default;
+        };
+
+        struct KeyHash {
+            std::size_t operator()(const Key& key) const noexcept
+            {
+                auto a = reinterpret_cast<std::uintptr_t>(key.file);
+                auto b = reinterpret_cast<std::uintptr_t>(key.function);
+                return std::hash<std::uintptr_t>{}(a ^ (b * 0x9E3779B97F4A7C15ULL));
+            }
+        };
+
+        thread_local std::unordered_map<Key, Site, KeyHash> cache;
+        const Key key{location.file_name(), location.function_name()};
+
+        if (auto it = cache.find(key); it != cache.end()) return it->second;
+
+        std::string_view path = key.file;
+        auto& pool = StringPool::Global();
+        auto file = pool(path.substr(path.find_last_of("/\\") + 1));
+        auto function = pool(key.function);
+        return cache.emplace(key, Site{file, function}).first->second;
+    }
+
+}
+
+#endif //LIBS_INTERNING_HPP
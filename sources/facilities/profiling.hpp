@@ -0,0 +1,540 @@
+#ifndef LIBS_PROFILING_HPP
+#define LIBS_PROFILING_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <map>
+#include <tuple>
+#include <memory>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <bit>
+#include <experimental/source_location>
+
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#include <cpuid.h>
+#endif
+
+#include "./formatting.hpp"
+#include "./interning.hpp"
+
+/// Zones are recorded unless the build defines HLIBS_PROFILING as 0 (e.g. -DHLIBS_PROFILING=0); then Zone is an empty
+/// class and the instrumented code compiles to nothing.
+#if !defined(HLIBS_PROFILING)
+#define HLIBS_PROFILING 1
+#endif
+
+
+namespace hlibs::facilities::profiling {
+
+    /// Measures time in ticks of the time stamp counter, if the CPU has an invariant one (constant rate, never stops),
+    /// or in nanoseconds of std::chrono::steady_clock otherwise; reading it costs a few nanoseconds with the TSC.
+    class Stopwatch final {
+      public:
+        Stopwatch() noexcept: start(Ticks())
+        {
+        }
+
+        static std::uint64_t Ticks() noexcept
+        {
+#if defined(__x86_64__)
+            if (HasInvariantTSC()) return __rdtsc();
+#endif
+            auto now = std::chrono::steady_clock::now().time_since_epoch();
+            return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now).count());
+        }
+
+        /// Ticks per nanosecond: 1 for steady_clock; for the TSC, measured against steady_clock over 20 ms on the first call.
+        static double Rate() noexcept
+        {
+            static const double rate = [] {
+                if (!HasInvariantTSC()) return 1.0;
+
+                const auto from = std::chrono::steady_clock::now();
+                const auto first = Ticks();
+                auto to = from;
+                while (to - from < std::chrono::milliseconds(20)) to = std::chrono::steady_clock::now();
+                const auto last = Ticks();
+
+                return static_cast<double>(last - first) / static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(to - from).count());
+            }();
+
+            return rate;
+        }
+
+        static std::chrono::nanoseconds ToDuration(std::uint64_t ticks) noexcept
+        {
+            return std::chrono::nanoseconds(static_cast<std::int64_t>(static_cast<double>(ticks) / Rate()));
+        }
+
+        [[nodiscard]] std::chrono::nanoseconds elapsed() const noexcept
+        {
+            return ToDuration(Ticks() - start);
+        }
+
+        void restart() noexcept
+        {
+            start = Ticks();
+        }
+
+      private:
+        static bool HasInvariantTSC() noexcept
+        {
+#if defined(__x86_64__)
+            static const bool invariant = [] {
+                unsigned eax = 0, ebx = 0, ecx = 0, edx = 0;
+                return __get_cpuid(0x80000007, &eax, &ebx, &ecx, &edx) != 0 && (edx & (1U << 8)) != 0;
+            }();
+            return invariant;
+#else
+            return false;
+#endif
+        }
+
+        std::uint64_t start;
+    };
+
+
+    /// Zone as collected from the buffers, with times in nanoseconds since the profiler was created.
+    struct Record {
+        std::string_view name;
+        std::string_view file;
+        std::string_view function;
+        std::uint32_t line;
+        std::uint32_t thread;           ///< 1, 2, … in the order of the first zone of each thread
+        std::uint64_t begin;
+        std::uint64_t duration;
+
+        bool operator==(const Record& rhs) const noexcept = default;
+    };
+
+
+    /// Keeps the zones of every thread in a ring buffer of its own (the latest capacity of them), so recording takes no lock
+    /// and shares no cache line with other threads: a thread registers its buffer under a lock once, then only writes to
+    /// it. collect() may run at any time; every slot is guarded like a seqlock, so an event overwritten while it is being
+    /// copied is left out rather than torn.
+    class Profiler final {
+        friend class Zone;
+
+      public:
+        using Source = std::experimental::source_location;
+
+        explicit Profiler(std::size_t capacity = 1UL << 16): size(std::bit_ceil(std::max<std::size_t>(capacity, 2))), origin(Stopwatch::Ticks())
+        {
+        }
+
+        Profiler(const Profiler& rhs) = delete;
+        Profiler& operator=(const Profiler& rhs) = delete;
+
+        Profiler(Profiler&& rhs) noexcept = delete;
+        Profiler& operator=(Profiler&& rhs) noexcept = delete;
+
+        ~Profiler() noexcept = default;
+
+        /// The profiler of the zones.
+        static Profiler& Global()
+        {
+            static Profiler profiler;
+            return profiler;
+        }
+
+        /// Stores a zone of the calling thread (without a name, it is named after the function); begin and end are ticks of Stopwatch.
+        /// Only the pointer of the name is kept, so it must have static storage duration (a string literal).
+        void record(const char* name, const Source& location, std::uint64_t begin, std::uint64_t end) noexcept
+        {
+            if (auto* buffer = tryLocal()) store(*buffer, name, location, begin, end);
+        }
+
+        /// The zones recorded since creation or clear() that have not been overwritten, ordered by their beginnings.
+        [[nodiscard]] std::vector<Record> collect() const
+        {
+            std::vector<Record> records;
+            std::lock_guard lock(mutex);
+
+            for (const auto& buffer : buffers) {
+                const auto head = buffer->head.load(std::memory_order_acquire);
+                const auto from = std::max(buffer->floor, head > size ? head - size : 0);
+                const auto copied = records.size();
+
+                for (auto index = from; index != head; ++index) {
+                    const auto& slot = buffer->slots[index & (size - 1)];
+                    const auto begin = slot.begin.load(std::memory_order_relaxed);
+                    const auto end = slot.end.load(std::memory_order_relaxed);
+                    const char* name = slot.name.load(std::memory_order_relaxed);
+                    const char* function = slot.function.load(std::memory_order_relaxed);
+
+                    records.push_back(Record{
+                            name != nullptr ? name : function,
+                            BaseName(slot.file.load(std::memory_order_relaxed)),
+                            function,
+                            slot.line.load(std::memory_order_relaxed),
+                            buffer->thread,
+                            static_cast<std::uint64_t>(Stopwatch::ToDuration(Since(origin, begin)).count()),
+                            static_cast<std::uint64_t>(Stopwatch::ToDuration(Since(begin, end)).count())
+                    });
+                }
+
+                std::atomic_thread_fence(std::memory_order_acquire);
+                const auto writing = buffer->writing.load(std::memory_order_relaxed);
+                const auto valid = writing > size ? writing - size : 0;
+                if (valid > from) records.erase(records.begin() + static_cast<std::ptrdiff_t>(copied), records.begin() + static_cast<std::ptrdiff_t>(copied + std::min(valid, head) - from));
+            }
+
+            std::ranges::sort(records, [](const Record& lhs, const Record& rhs) {
+                return std::tie(lhs.begin, rhs.duration, lhs.thread) < std::tie(rhs.begin, lhs.duration, rhs.thread);
+            });
+            return records;
+        }
+
+        /// Forgets the zones recorded so far (threads may go on recording).
+        void clear() noexcept
+        {
+            std::lock_guard lock(mutex);
+            for (auto& buffer : buffers) buffer->floor = buffer->head.load(std::memory_order_acquire);
+        }
+
+        /// Number of zones overwritten before they were collected (since creation or clear()).
+        [[nodiscard]] std::uint64_t dropped() const noexcept
+        {
+            std::lock_guard lock(mutex);
+            std::uint64_t count = 0;
+
+            for (const auto& buffer : buffers) {
+                auto recorded = buffer->head.load(std::memory_order_acquire) - buffer->floor;
+                count += recorded > size ? recorded - size : 0;
+            }
+
+            return count;
+        }
+
+        inline std::size_t capacity() const noexcept
+        {
+            return size;
+        }
+
+      private:
+        struct Slot {
+            std::atomic<std::uint64_t> begin{0};
+            std::atomic<std::uint64_t> end{0};
+            std::atomic<const char*> name{nullptr};
+            std::atomic<const char*> file{""};
+            std::atomic<const char*> function{""};
+            std::atomic<std::uint32_t> line{0};
+        };
+
+        struct Buffer {
+            Buffer(std::size_t capacity, std::thread::id id, std::uint32_t number): slots(std::make_unique<Slot[]>(capacity)), owner(id), thread(number)
+            {
+            }
+
+            std::unique_ptr<Slot[]> slots;
+            std::thread::id owner;
+            std::uint32_t thread;
+            alignas(64) std::atomic<std::uint64_t> head{0};     ///< number of events written
+            std::atomic<std::uint64_t> writing{0};              ///< number of events written or being written
+            std::uint64_t floor = 0;                            ///< head at clear(), guarded by the mutex
+        };
+
+        /// Writes a zone into the buffer of the calling thread.
+        void store(Buffer& buffer, const char* name, const Source& location, std::uint64_t begin, std::uint64_t end) noexcept
+        {
+            const auto index = buffer.head.load(std::memory_order_relaxed);
+            auto& slot = buffer.slots[index & (size - 1)];
+
+            buffer.writing.store(index + 1, std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_release);
+
+            slot.begin.store(begin, std::memory_order_relaxed);
+            slot.end.store(end, std::memory_order_relaxed);
+            slot.name.store(name, std::memory_order_relaxed);
+            slot.file.store(location.file_name(), std::memory_order_relaxed);
+            slot.function.store(location.function_name(), std::memory_order_relaxed);
+            slot.line.store(location.line(), std::memory_order_relaxed);
+
+            buffer.head.store(index + 1, std::memory_order_release);
+        }
+
+        /// The buffer of the calling thread; cached per thread by the generation of the profiler, so an address reused by
+        /// another profiler is not mistaken for this one.
+        Buffer& local()
+        {
+            struct Cache {
+                std::uint64_t generation = 0;
+                Buffer* buffer = nullptr;
+            };
+
+            thread_local Cache cache;
+            if (cache.generation == generation) return *cache.buffer;
+
+            std::lock_guard lock(mutex);
+            const auto id = std::this_thread::get_id();
+            auto it = std::ranges::find_if(buffers, [id](const auto& buffer) { return buffer->owner == id; });
+
+            if (it == buffers.end()) {
+                buffers.push_back(std::make_unique<Buffer>(size, id, static_cast<std::uint32_t>(buffers.size() + 1)));
+                it = std::prev(buffers.end());
+            }
+
+            cache = {generation, it->get()};
+            return **it;
+        }
+
+        /// The buffer of the calling thread, or null when it cannot be registered (the zone is then left unrecorded, as
+        /// profiling must not terminate the program).
+        Buffer* tryLocal() noexcept
+        {
+            try {
+                return &local();
+            }
+            catch (...) {
+                return nullptr;
+            }
+        }
+
+        static std::string_view BaseName(std::string_view path) noexcept
+        {
+            return path.substr(path.find_last_of("/\\") + 1);
+        }
+
+        /// Ticks from one reading to a later one; 0 if the later one is not (ticks of different cores may disagree slightly).
+        static std::uint64_t Since(std::uint64_t from, std::uint64_t to) noexcept
+        {
+            return to > from ? to - from : 0;
+        }
+
+        static std::uint64_t NextGeneration() noexcept
+        {
+            static std::atomic<std::uint64_t> counter = 0;
+            return ++counter;
+        }
+
+        const std::size_t size;
+        const std::uint64_t origin;
+        const std::uint64_t generation = NextGeneration();
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<Buffer>> buffers;
+    };
+
+
+#if HLIBS_PROFILING
+    /// Records the time between its construction and destruction as a zone of the global profiler, e.g.
+    /// { Zone zone("parse"); … }. It costs two reads of the Stopwatch and a few stores into the thread's buffer. The name must
+    /// have static storage duration (a string literal), as it is read when the zones are collected. The profiler and the
+    /// buffer of the thread are set up before the clock is read, so the first zone neither precedes the origin of the
+    /// profiler nor includes the allocation of the buffer; if that allocation fails, the zone is not recorded.
+    class Zone final {
+      public:
+        explicit Zone(const char* name = nullptr, const Profiler::Source& location = Profiler::Source::current()) noexcept
+                : profiler(Profiler::Global()), buffer(profiler.tryLocal()), label(name), site(location), begin(Stopwatch::Ticks())
+        {
+        }
+
+        Zone(const Zone& rhs) = delete;
+        Zone& operator=(const Zone& rhs) = delete;
+
+        Zone(Zone&& rhs) noexcept = delete;
+        Zone& operator=(Zone&& rhs) noexcept = delete;
+
+        ~Zone() noexcept
+        {
+            if (buffer != nullptr) profiler.store(*buffer, label, site, begin, Stopwatch::Ticks());
+        }
+
+      private:
+        Profiler& profiler;
+        Profiler::Buffer* buffer;
+        const char* label;
+        Profiler::Source site;
+        std::uint64_t begin;
+    };
+#else
+    class Zone final {
+      public:
+        explicit Zone(const char* = nullptr, const Profiler::Source& = Profiler::Source::current()) noexcept
+        {
+        }
+
+        Zone(const Zone& rhs) = delete;
+        Zone& operator=(const Zone& rhs) = delete;
+
+        Zone(Zone&& rhs) noexcept = delete;
+        Zone& operator=(Zone&& rhs) noexcept = delete;
+
+        ~Zone() noexcept = default;
+    };
+#endif
+
+
+    /// Writes the records as a JSON trace of complete ("X") events into any sink with write(std::string_view), such as
+    /// io::FileWriter; it opens in chrome://tracing or https://ui.perfetto.dev.
+    /// url:https://docs.google.com/document/d/1CvAClvFfyA5R-PhYUmn5OOQtYMH4h6I0nSsKchNAySU
+    template<typename Sink>
+    static void ExportChromeTrace(const std::vector<Record>& records, Sink& sink)
+    {
+        formatting::StringBuilder<4096> builder;
+
+        const auto quoted = [&builder](std::string_view text) {
+            builder.append('"');
+            for (char ch : text) {
+                if (ch == '"' || ch == '\\') builder.append('\\').append(ch);
+                else if (static_cast<unsigned char>(ch) < 0x20) builder.append("\\u00").append(ch >> 4 ? '1' : '0').append("0123456789abcdef"[ch & 0xF]);
+                else builder.append(ch);
+            }
+            builder.append('"');
+        };
+
+        builder.append(R"({"displayTimeUnit":"ns","traceEvents":[)");
+
+        for (std::size_t i = 0; i != records.size(); ++i) {
+            const auto& record = records[i];
+            if (i != 0) builder.append(',');
+
+            builder.append(R"({"name":)");
+            quoted(record.name);
+            builder.append(R"(,"cat":"zone","ph":"X","pid":1,"tid":)").append(record.thread);
+            builder.append(R"(,"ts":)").append(static_cast<double>(record.begin) / 1000, std::chars_format::fixed, 3);
+            builder.append(R"(,"dur":)").append(static_cast<double>(record.duration) / 1000, std::chars_format::fixed, 3);
+            builder.append(R"(,"args":{"file":)");
+            quoted(record.file);
+            builder.append(R"(,"line":)").append(record.line).append(R"(,"function":)");
+            quoted(record.function);
+            builder.append("}}");
+
+            if (builder.size() >= (1UL << 16)) {
+                sink.write(builder.view());
+                builder.clear();
+            }
+        }
+
+        builder.append("]}");
+        sink.write(builder.view());
+    }
+
+
+    /// Header of the binary format: the magic with the version, then the numbers of sites and records (all little endian).
+    static constexpr std::string_view BinaryMagic{"HLPROF\x01\0", 8};
+
+    /// Writes the records in the binary format: every distinct site (line, then name, file and function as 32-bit length
+    /// and bytes) once, then 24 bytes per record (site index, thread, begin, duration), into any sink with write(std::string_view).
+    template<typename Sink>
+    static void ExportBinary(const std::vector<Record>& records, Sink& sink)
+    {
+        using SiteKey = std::tuple<std::string_view, std::string_view, std::string_view, std::uint32_t>;
+
+        formatting::StringBuilder<4096> builder;
+        std::map<SiteKey, std::uint32_t> sites;
+        std::vector<const Record*> order;
+
+        const auto number = [&builder]<typename T>(T value) {
+            if constexpr (std::endian::native == std::endian::big) {
+                if constexpr (sizeof(T) == 4) value = __builtin_bswap32(value);
+                else value = __builtin_bswap64(value);
+            }
+            std::memcpy(builder.extend(sizeof(T)).data(), &value, sizeof(T));
+        };
+
+        const auto text = [&](std::string_view str) {
+            number(static_cast<std::uint32_t>(str.size()));
+            builder.append(str);
+        };
+
+        for (const auto& record : records) {
+            auto [it, added] = sites.try_emplace(SiteKey{record.name, record.file, record.function, record.line}, static_cast<std::uint32_t>(sites.size()));
+            if (added) order.push_back(&record);
+        }
+
+        builder.append(BinaryMagic);
+        number(static_cast<std::uint32_t>(sites.size()));
+        number(static_cast<std::uint64_t>(records.size()));
+
+        for (const auto* site : order) {
+            number(site->line);
+            text(site->name);
+            text(site->file);
+            text(site->function);
+        }
+
+        for (const auto& record : records) {
+            number(sites.at(SiteKey{record.name, record.file, record.function, record.line}));
+            number(record.thread);
+            number(record.begin);
+            number(record.duration);
+
+            if (builder.size() >= (1UL << 16)) {
+                sink.write(builder.view());
+                builder.clear();
+            }
+        }
+
+        sink.write(builder.view());
+    }
+
+    /// Reads records written by ExportBinary(); their strings are kept in the pool.
+    [[maybe_unused]] static std::vector<Record> ImportBinary(std::string_view bytes, interning::StringPool& pool = interning::StringPool::Global())
+    {
+        const auto number = [&bytes]<typename T>(T& value) {
+            if (bytes.size() < sizeof(T)) throw std::invalid_argument("bytes.size() < sizeof(T)");
+            std::memcpy(&value, bytes.data(), sizeof(T));
+            bytes.remove_prefix(sizeof(T));
+
+            if constexpr (std::endian::native == std::endian::big) {
+                if constexpr (sizeof(T) == 4) value = __builtin_bswap32(value);
+                else value = __builtin_bswap64(value);
+            }
+        };
+
+        const auto text = [&]() {
+            std::uint32_t length = 0;
+            number(length);
+            if (bytes.size() < length) throw std::invalid_argument("bytes.size() < length");
+            auto str = pool(bytes.substr(0, length));
+            bytes.remove_prefix(length);
+            return str;
+        };
+
+        if (!bytes.starts_with(BinaryMagic)) throw std::invalid_argument("!bytes.starts_with(BinaryMagic)");
+        bytes.remove_prefix(BinaryMagic.size());
+
+        std::uint32_t site_count = 0;
+        std::uint64_t record_count = 0;
+        number(site_count);
+        number(record_count);
+
+        if (site_count > bytes.size() / 16) throw std::invalid_argument("site_count > bytes.size() / 16");    // line and three lengths at least
+        std::vector<Record> sites(site_count);
+        for (auto& site : sites) {
+            number(site.line);
+            site.name = text();
+            site.file = text();
+            site.function = text();
+        }
+
+        if (record_count > bytes.size() / 24) throw std::invalid_argument("record_count > bytes.size() / 24");
+        if (bytes.size() != record_count * 24) throw std::invalid_argument("bytes.size() != record_count * 24");
+        std::vector<Record> records(record_count);
+
+        for (auto& record : records) {
+            std::uint32_t site = 0;
+            number(site);
+            if (site >= sites.size()) throw std::invalid_argument("site >= sites.size()");
+
+            record = sites[site];
+            number(record.thread);
+            number(record.begin);
+            number(record.duration);
+        }
+
+        return records;
+    }
+
+}
+
+#endif //LIBS_PROFILING_HPP
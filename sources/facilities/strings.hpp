@@ -5,18 +5,209 @@
 #include <string_view>
 #include <ranges>
 #include <algorithm>
-#include <regex>
+#include <span>
+#include <optional>
+#include <charconv>
+#include <type_traits>
+#include <array>
+#include <cstring>
+#include <iterator>
+#include <utility>
+#include <vector>
+#include <deque>
+#include <initializer_list>
+#include <stdexcept>
+#include <cstdint>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
 
 
 namespace hlibs::facilities::strings {
 
+    /// ASCII case conversion: only 'a'-'z' and 'A'-'Z' change, any other byte (UTF-8 sequences included) is copied as is.
+    /// It does not depend on the locale.
+    [[maybe_unused]] static constexpr char ToUpper(char ch) noexcept
+    {
+        return static_cast<unsigned char>(ch - 'a') < 26 ? static_cast<char>(ch ^ 0x20) : ch;
+    }
+
+    [[maybe_unused]] static constexpr char ToLower(char ch) noexcept
+    {
+        return static_cast<unsigned char>(ch - 'A') < 26 ? static_cast<char>(ch ^ 0x20) : ch;
+    }
+
+
+#if defined(__x86_64__)
+    /// Flips the case of the letters First-Last, 32 bytes per step; returns the number of bytes converted.
+    /// Bytes above 0x7F are negative as signed chars, so they never fall into the range.
+    template<char First, char Last>
+    __attribute__((target("avx2"))) static std::size_t FlipCaseAVX2(const char* source, char* target, std::size_t n) noexcept
+    {
+        const __m256i below = _mm256_set1_epi8(First - 1);
+        const __m256i above = _mm256_set1_epi8(Last + 1);
+        const __m256i bit = _mm256_set1_epi8(0x20);
+        std::size_t i = 0;
+
+        for (; n - i >= 32; i += 32) {
+            __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(source + i));
+            __m256i letters = _mm256_and_si256(_mm256_cmpgt_epi8(chars, below), _mm256_cmpgt_epi8(above, chars));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(target + i), _mm256_xor_si256(chars, _mm256_and_si256(letters, bit)));
+        }
+
+        return i;
+    }
+
+    template<char First, char Last>
+    static std::size_t FlipCaseSSE2(const char* source, char* target, std::size_t n) noexcept
+    {
+        const __m128i below = _mm_set1_epi8(First - 1);
+        const __m128i above = _mm_set1_epi8(Last + 1);
+        const __m128i bit = _mm_set1_epi8(0x20);
+        std::size_t i = 0;
+
+        for (; n - i >= 16; i += 16) {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(source + i));
+            __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(chars, below), _mm_cmplt_epi8(chars, above));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(target + i), _mm_xor_si128(chars, _mm_and_si128(letters, bit)));
+        }
+
+        return i;
+    }
+
+    /// Returns the index of the first pair of bytes different after folding to lowercase (or n, if there is none).
+    __attribute__((target("avx2"))) static std::size_t MismatchIgnoreCaseAVX2(const char* lhs, const char* rhs, std::size_t n) noexcept
+    {
+        const __m256i below = _mm256_set1_epi8('A' - 1);
+        const __m256i above = _mm256_set1_epi8('Z' + 1);
+        const __m256i bit = _mm256_set1_epi8(0x20);
+        std::size_t i = 0;
+
+        for (; n - i >= 32; i += 32) {
+            __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(lhs + i));
+            __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(rhs + i));
+            a = _mm256_or_si256(a, _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi8(a, below), _mm256_cmpgt_epi8(above, a)), bit));
+            b = _mm256_or_si256(b, _mm256_and_si256(_mm256_and_si256(_mm256_cmpgt_epi8(b, below), _mm256_cmpgt_epi8(above, b)), bit));
+            auto equal = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(a, b)));
+            if (equal != 0xFFFFFFFFU) return i + static_cast<std::size_t>(__builtin_ctz(~equal));
+        }
+
+        return i;
+    }
+
+    static std::size_t MismatchIgnoreCaseSSE2(const char* lhs, const char* rhs, std::size_t n) noexcept
+    {
+        const __m128i below = _mm_set1_epi8('A' - 1);
+        const __m128i above = _mm_set1_epi8('Z' + 1);
+        const __m128i bit = _mm_set1_epi8(0x20);
+        std::size_t i = 0;
+
+        for (; n - i >= 16; i += 16) {
+            __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lhs + i));
+            __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(rhs + i));
+            a = _mm_or_si128(a, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi8(a, below), _mm_cmplt_epi8(a, above)), bit));
+            b = _mm_or_si128(b, _mm_and_si128(_mm_and_si128(_mm_cmpgt_epi8(b, below), _mm_cmplt_epi8(b, above)), bit));
+            auto equal = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(a, b)));
+            if (equal != 0xFFFFU) return i + static_cast<std::size_t>(__builtin_ctz(~equal));
+        }
+
+        return i;
+    }
+#endif
+
+    /// Converts n bytes (source and target may be the same); SIMD for the bulk, scalar for the tail.
+    template<char First, char Last>
+    static void FlipCase(const char* source, char* target, std::size_t n) noexcept
+    {
+        std::size_t i = 0;
+
+#if defined(__x86_64__)
+        static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+        if (hasAVX2) i = FlipCaseAVX2<First, Last>(source, target, n);
+        i += FlipCaseSSE2<First, Last>(source + i, target + i, n - i);
+#endif
+
+        for (; i != n; ++i) {
+            char ch = source[i];
+            target[i] = static_cast<unsigned char>(ch - First) <= Last - First ? static_cast<char>(ch ^ 0x20) : ch;
+        }
+    }
+
+    [[maybe_unused]] static std::size_t MismatchIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept
+    {
+        const std::size_t n = std::min(lhs.size(), rhs.size());
+        std::size_t i = 0;
+
+#if defined(__x86_64__)
+        static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+        if (hasAVX2) i = MismatchIgnoreCaseAVX2(lhs.data(), rhs.data(), n);
+        if (i != n && ToLower(lhs[i]) == ToLower(rhs[i])) i += MismatchIgnoreCaseSSE2(lhs.data() + i, rhs.data() + i, n - i);
+#endif
+
+        while (i != n && ToLower(lhs[i]) == ToLower(rhs[i])) ++i;
+        return i;
+    }
+
+
+    /// Writes source.size() bytes into the target (without allocating); returns their number.
+    [[maybe_unused]] static std::size_t ToUpperCase(std::string_view source, std::span<char> target)
+    {
+        if (target.size() < source.size()) throw std::length_error("target.size() < source.size()");
+        FlipCase<'a', 'z'>(source.data(), target.data(), source.size());
+        return source.size();
+    }
+
+    [[maybe_unused]] static std::size_t ToLowerCase(std::string_view source, std::span<char> target)
+    {
+        if (target.size() < source.size()) throw std::length_error("target.size() < source.size()");
+        FlipCase<'A', 'Z'>(source.data(), target.data(), source.size());
+        return source.size();
+    }
+
+    [[maybe_unused]] static void ToUpperCaseInPlace(std::span<char> text) noexcept
+    {
+        FlipCase<'a', 'z'>(text.data(), text.data(), text.size());
+    }
+
+    [[maybe_unused]] static void ToLowerCaseInPlace(std::span<char> text) noexcept
+    {
+        FlipCase<'A', 'Z'>(text.data(), text.data(), text.size());
+    }
+
     [[maybe_unused]] static std::string ToUpperCase(std::string_view source)
     {
         std::string str{source};
-        std::ranges::transform(str, str.begin(), ::toupper);
+        ToUpperCaseInPlace(str);
+        return str;
+    }
+
+    [[maybe_unused]] static std::string ToLowerCase(std::string_view source)
+    {
+        std::string str{source};
+        ToLowerCaseInPlace(str);
         return str;
     }
 
+    [[maybe_unused]] static bool EqualsIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept
+    {
+        return lhs.size() == rhs.size() && MismatchIgnoreCase(lhs, rhs) == lhs.size();
+    }
+
+    /// Three-way comparison of the texts folded to lowercase (bytes compared as unsigned, like std::string_view::compare).
+    [[maybe_unused]] static int CompareIgnoreCase(std::string_view lhs, std::string_view rhs) noexcept
+    {
+        auto i = MismatchIgnoreCase(lhs, rhs);
+
+        if (i == std::min(lhs.size(), rhs.size())) {
+            return lhs.size() == rhs.size() ? 0 : (lhs.size() < rhs.size() ? -1 : 1);
+        }
+
+        auto a = static_cast<unsigned char>(ToLower(lhs[i]));
+        auto b = static_cast<unsigned char>(ToLower(rhs[i]));
+        return a < b ? -1 : 1;
+    }
+
     [[maybe_unused]] static bool Contains(std::string_view source, char what) noexcept
     {
         return source.find(what) != std::string::npos;
@@ -27,24 +218,655 @@ namespace hlibs::facilities::strings {
         return source.find(what) != std::string::npos;
     }
 
+    [[maybe_unused]] static constexpr bool IsDigit(char ch) noexcept
+    {
+        return static_cast<unsigned char>(ch - '0') < 10;
+    }
+
+
+    /// Character classes of CheckRange(), to be combined with '|'. They are ASCII only and do not depend on the locale, so
+    /// a byte above 0x7F (e.g. of a UTF-8 sequence) belongs to none of them.
+    enum class CharClass : std::uint8_t {
+        Letters = 1,                    ///< 'a'-'z', 'A'-'Z'
+        Digits = 2,                     ///< '0'-'9'
+        Special = 4,                    ///< printable, but not alphanumeric (the space included)
+        ControlChars = 8,               ///< 0x00-0x1F and 0x7F
+        Alphanumerics = Letters | Digits,
+        ASCII = Letters | Digits | Special | ControlChars
+    };
+
+    [[maybe_unused]] static constexpr CharClass operator|(CharClass lhs, CharClass rhs) noexcept
+    {
+        return static_cast<CharClass>(static_cast<std::uint8_t>(lhs) | static_cast<std::uint8_t>(rhs));
+    }
+
+    /// The classes of every byte, as bits of CharClass.
+    [[maybe_unused]] static constexpr std::array<std::uint8_t, 256> CharClasses = [] {
+        std::array<std::uint8_t, 256> table{};
+
+        for (unsigned byte = 0; byte != 128; ++byte) {
+            if (byte < 0x20 || byte == 0x7F) table[byte] = static_cast<std::uint8_t>(CharClass::ControlChars);
+            else if (IsDigit(static_cast<char>(byte))) table[byte] = static_cast<std::uint8_t>(CharClass::Digits);
+            else if (ToLower(static_cast<char>(byte)) != ToUpper(static_cast<char>(byte))) table[byte] = static_cast<std::uint8_t>(CharClass::Letters);
+            else table[byte] = static_cast<std::uint8_t>(CharClass::Special);
+        }
+
+        return table;
+    }();
+
+    /// Set of bytes as two 16-entry tables indexed by the low and the high nibble of a byte: it is a member if the entries
+    /// have a common bit. High nibbles with the same set of low nibbles share a bit; only 0x0-0x7 have any members, so
+    /// 8 bits are enough for every combination of the classes.
+    /// url:http://0x80.pl/articles/simd-byte-lookup.html
+    struct NibbleMasks {
+        std::array<std::uint8_t, 16> low{};
+        std::array<std::uint8_t, 16> high{};
+    };
+
+    [[maybe_unused]] static constexpr std::array<NibbleMasks, 16> CharClassMasks = [] {
+        std::array<NibbleMasks, 16> tables{};
+
+        for (unsigned classes = 0; classes != tables.size(); ++classes) {
+            auto& masks = tables[classes];
+            std::array<std::uint16_t, 8> rows{};
+            unsigned count = 0;
+
+            for (unsigned high = 0; high != 8; ++high) {
+                std::uint16_t row = 0;
+                for (unsigned low = 0; low != 16; ++low) {
+                    if (CharClasses[high * 16 + low] & classes) row = static_cast<std::uint16_t>(row | (1U << low));
+                }
+                if (row == 0) continue;
+
+                unsigned bit = 0;
+                while (bit != count && rows[bit] != row) ++bit;
+                if (bit == count) rows[count++] = row;
+                masks.high[high] = static_cast<std::uint8_t>(masks.high[high] | (1U << bit));
+            }
+
+            for (unsigned bit = 0; bit != count; ++bit) {
+                for (unsigned low = 0; low != 16; ++low) {
+                    if (rows[bit] & (1U << low)) masks.low[low] = static_cast<std::uint8_t>(masks.low[low] | (1U << bit));
+                }
+            }
+        }
+
+        return tables;
+    }();
+
+
+#if defined(__x86_64__)
+    /// Bit per byte of the 32 at text, set if the byte is outside the set.
+    __attribute__((target("avx2"))) static inline std::uint32_t OutsideAVX2(const char* text, __m256i low, __m256i high) noexcept
+    {
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        __m256i chars = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text));
+        __m256i lows = _mm256_shuffle_epi8(low, _mm256_and_si256(chars, nibble));
+        __m256i highs = _mm256_shuffle_epi8(high, _mm256_and_si256(_mm256_srli_epi16(chars, 4), nibble));
+        return static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_cmpeq_epi8(_mm256_and_si256(lows, highs), _mm256_setzero_si256())));
+    }
+
+    /// Returns the index of the first byte outside the set within n, or where the bulk of 32-byte blocks ends; 64 bytes per step.
+    __attribute__((target("avx2"))) static std::size_t FindNotInAVX2(const char* text, std::size_t n, const NibbleMasks& masks) noexcept
+    {
+        const __m256i low = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(masks.low.data())));
+        const __m256i high = _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(masks.high.data())));
+        std::size_t i = 0;
+
+        for (; n - i >= 64; i += 64) {
+            auto mask = OutsideAVX2(text + i, low, high) | static_cast<std::uint64_t>(OutsideAVX2(text + i + 32, low, high)) << 32;
+            if (mask != 0) return i + static_cast<std::size_t>(__builtin_ctzll(mask));
+        }
+
+        if (n - i >= 32) {
+            auto mask = OutsideAVX2(text + i, low, high);
+            if (mask != 0) return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            i += 32;
+        }
+
+        return i;
+    }
+
+    __attribute__((target("ssse3"))) static std::size_t FindNotInSSSE3(const char* text, std::size_t n, const NibbleMasks& masks) noexcept
+    {
+        const __m128i low = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks.low.data()));
+        const __m128i high = _mm_loadu_si128(reinterpret_cast<const __m128i*>(masks.high.data()));
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        std::size_t i = 0;
+
+        for (; n - i >= 16; i += 16) {
+            __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+            __m128i lows = _mm_shuffle_epi8(low, _mm_and_si128(chars, nibble));
+            __m128i highs = _mm_shuffle_epi8(high, _mm_and_si128(_mm_srli_epi16(chars, 4), nibble));
+            auto outside = static_cast<std::uint32_t>(_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_and_si128(lows, highs), _mm_setzero_si128())));
+            if (outside != 0) return i + static_cast<std::size_t>(__builtin_ctz(outside));
+        }
+
+        return i;
+    }
+#endif
+
+    /// Returns the index of the first character of the text that is in none of the classes, or std::string_view::npos.
+    [[maybe_unused]] static std::size_t FindNotIn(std::string_view text, CharClass classes) noexcept
+    {
+        const auto bits = static_cast<std::uint8_t>(static_cast<std::uint8_t>(classes) & 0x0F);
+        const auto in = [bits](char ch) { return (CharClasses[static_cast<unsigned char>(ch)] & bits) != 0; };
+        const std::size_t n = text.size();
+        std::size_t i = 0;
+
+#if defined(__x86_64__)
+        static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+        static const bool hasSSSE3 = __builtin_cpu_supports("ssse3");
+        if (hasAVX2) i = FindNotInAVX2(text.data(), n, CharClassMasks[bits]);
+        if (hasSSSE3 && i != n && in(text[i])) i += FindNotInSSSE3(text.data() + i, n - i, CharClassMasks[bits]);
+#endif
+
+        while (i != n && in(text[i])) ++i;
+        return i == n ? std::string_view::npos : i;
+    }
+
+    /// Checks if every character of the text is in one of the classes, e.g. CheckRange(id, CharClass::Alphanumerics | CharClass::Special).
+    [[maybe_unused]] static bool CheckRange(std::string_view text, CharClass classes) noexcept
+    {
+        return FindNotIn(text, classes) == std::string_view::npos;
+    }
+
     /// Checks if str consists only of digits.
-    [[maybe_unused]] static bool IsNumber(std::string_view str)
+    [[maybe_unused]] static bool IsNumber(std::string_view str) noexcept
     {
-        bool hasOnlyDigits = true;
+        return CheckRange(str, CharClass::Digits);
+    }
 
-        auto isNumber = [&hasOnlyDigits](const auto& ch) {
-            hasOnlyDigits = hasOnlyDigits && std::isdigit(ch);
-        };
+    /// Returns the length of the number notation (e.g. +1.0, -1, 2.) at the beginning of str, or 0 if it does not start with one.
+    [[maybe_unused]] static constexpr std::size_t ScanNumeric(std::string_view str) noexcept
+    {
+        std::size_t i = !str.empty() && (str[0] == '+' || str[0] == '-');
+        const std::size_t digits = i;
+
+        while (i != str.size() && IsDigit(str[i])) ++i;
+        if (i == digits) return 0;
+
+        if (i != str.size() && str[i] == '.') {
+            for (++i; i != str.size() && IsDigit(str[i]); ++i) {}
+        }
 
-        std::ranges::for_each(str, isNumber);
-        return hasOnlyDigits;
+        return i;
     }
 
     /// Checks if str corresponds to a number notation (e.g. +1.0, -1).
-    [[maybe_unused]] static bool IsNumeric(const std::string& str)
+    [[maybe_unused]] static bool IsNumeric(std::string_view str) noexcept
+    {
+        auto length = ScanNumeric(str);
+        return length != 0 && length == str.size();
+    }
+
+    /// Parses the notation accepted by IsNumeric (with no fractional part for an integral T); nullopt if invalid or out of range.
+    template<typename T> requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+    [[maybe_unused]] static std::optional<T> ParseNumeric(std::string_view str) noexcept
+    {
+        if (!IsNumeric(str)) return std::nullopt;
+
+        const char* first = str.data() + (str[0] == '+');
+        const char* last = str.data() + str.size();
+        T value{};
+        std::from_chars_result result{};
+
+        if constexpr (std::is_floating_point_v<T>) result = std::from_chars(first, last, value, std::chars_format::fixed);
+        else result = std::from_chars(first, last, value);
+
+        if (result.ec != std::errc() || result.ptr != last) return std::nullopt;
+        return value;
+    }
+
+    /// Returns the index of the first entry of the column that is not a number notation, or std::string_view::npos.
+    [[maybe_unused]] static std::size_t FindNonNumeric(std::span<const std::string_view> column) noexcept
+    {
+        auto it = std::ranges::find_if_not(column, [](std::string_view str) { return IsNumeric(str); });
+        return it == column.end() ? std::string_view::npos : static_cast<std::size_t>(it - column.begin());
+    }
+
+    /// Parses the column into the target; returns the number of entries parsed (less than column.size() if one is invalid).
+    template<typename T> requires std::is_arithmetic_v<T> && (!std::is_same_v<T, bool>)
+    [[maybe_unused]] static std::size_t ParseNumeric(std::span<const std::string_view> column, std::span<T> target)
+    {
+        if (target.size() < column.size()) throw std::length_error("target.size() < column.size()");
+
+        for (std::size_t i = 0; i != column.size(); ++i) {
+            auto value = ParseNumeric<T>(column[i]);
+            if (!value) return i;
+            target[i] = *value;
+        }
+
+        return column.size();
+    }
+
+
+    /// Delimiter of Split(): any single character of the set.
+    struct AnyOf {
+        std::string_view chars;
+    };
+
+
+#if defined(__x86_64__)
+    /// Returns the index of the first character of the set (up to 16 characters) within n, or n; 16 bytes per step.
+    /// url:https://www.felixcloutier.com/x86/pcmpestri
+    __attribute__((target("sse4.2"))) static std::size_t FindAnyOfSSE42(const char* text, std::size_t n, const char* set, int set_size) noexcept
+    {
+        const __m128i chars = _mm_loadu_si128(reinterpret_cast<const __m128i*>(set));
+        constexpr int mode = _SIDD_UBYTE_OPS | _SIDD_CMP_EQUAL_ANY | _SIDD_LEAST_SIGNIFICANT;
+        std::size_t i = 0;
+
+        for (; n - i >= 16; i += 16) {
+            __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text + i));
+            int at = _mm_cmpestri(chars, set_size, block, 16, mode);
+            if (at != 16) return i + static_cast<std::size_t>(at);
+        }
+
+        if (i == n) return n;
+        alignas(16) std::array<char, 16> tail{};
+        std::memcpy(tail.data(), text + i, n - i);
+        int at = _mm_cmpestri(chars, set_size, _mm_load_si128(reinterpret_cast<const __m128i*>(tail.data())), static_cast<int>(n - i), mode);
+        return at == 16 ? n : i + static_cast<std::size_t>(at);
+    }
+
+    /// Returns the index of the first occurrence of the needle (at least 2 characters) in the text, or npos. Positions where
+    /// both the first and the last character of the needle match are found 32 at a time, then verified with memcmp.
+    /// url:http://0x80.pl/articles/simd-strfind.html
+    __attribute__((target("avx2"))) static std::size_t FindSequenceAVX2(std::string_view text, std::string_view needle) noexcept
+    {
+        const std::size_t m = needle.size();
+        const __m256i first = _mm256_set1_epi8(needle.front());
+        const __m256i last = _mm256_set1_epi8(needle.back());
+        std::size_t i = 0;
+
+        for (; text.size() >= m - 1 + 32 && i <= text.size() - (m - 1) - 32; i += 32) {
+            __m256i heads = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i));
+            __m256i tails = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(text.data() + i + m - 1));
+            auto mask = static_cast<std::uint32_t>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(heads, first), _mm256_cmpeq_epi8(tails, last))));
+
+            for (; mask != 0; mask &= mask - 1) {
+                auto at = i + static_cast<std::size_t>(__builtin_ctz(mask));
+                if (std::memcmp(text.data() + at + 1, needle.data() + 1, m - 2) == 0) return at;
+            }
+        }
+
+        return text.find(needle, i);
+    }
+#endif
+
+
+    /// Lazy range of the tokens between delimiters: string_views into the text, so nothing is allocated (the text and a
+    /// sequence delimiter have to outlive it). Like std::views::split, an empty text has no tokens, and a delimiter at the
+    /// end is followed by an empty token; with skip_empty, empty tokens are left out.
+    class SplitView : public std::ranges::view_interface<SplitView> {
+      public:
+        class Iterator {
+          public:
+            using iterator_concept = std::forward_iterator_tag;
+            using iterator_category = std::forward_iterator_tag;
+            using value_type = std::string_view;
+            using difference_type = std::ptrdiff_t;
+
+            Iterator() = default;
+
+            Iterator(const SplitView* view, std::size_t from) noexcept: parent(view), next(from), finished(false)
+            {
+                advance();
+            }
+
+            std::string_view operator*() const noexcept
+            {
+                return token;
+            }
+
+            Iterator& operator++() noexcept
+            {
+                advance();
+                return *this;
+            }
+
+            Iterator operator++(int) noexcept
+            {
+                auto copy = *this;
+                advance();
+                return copy;
+            }
+
+            bool operator==(const Iterator& rhs) const noexcept
+            {
+                return next == rhs.next && finished == rhs.finished;
+            }
+
+            bool operator==(std::default_sentinel_t) const noexcept
+            {
+                return finished;
+            }
+
+          private:
+            void advance() noexcept
+            {
+                do {
+                    if (next == std::string_view::npos) {
+                        finished = true;
+                        return;
+                    }
+
+                    auto [at, length] = parent->find(next);
+                    token = parent->text.substr(next, at == std::string_view::npos ? std::string_view::npos : at - next);
+                    next = at == std::string_view::npos ? std::string_view::npos : at + length;
+                } while (parent->skip_empty && token.empty());
+            }
+
+            const SplitView* parent = nullptr;
+            std::size_t next = std::string_view::npos;
+            std::string_view token{};
+            bool finished = true;
+        };
+
+        SplitView() = default;
+
+        SplitView(std::string_view source, char delimiter, bool skip) noexcept: text(source), single(delimiter), kind(Kind::Char), skip_empty(skip)
+        {
+        }
+
+        SplitView(std::string_view source, std::string_view delimiter, bool skip): text(source), sequence(delimiter), kind(Kind::Sequence), skip_empty(skip)
+        {
+            if (delimiter.empty()) throw std::invalid_argument("delimiter.empty()");
+
+            if (delimiter.size() == 1) {
+                single = delimiter.front();
+                kind = Kind::Char;
+            }
+        }
+
+        SplitView(std::string_view source, AnyOf delimiters, bool skip): text(source), kind(Kind::AnyOf), skip_empty(skip)
+        {
+            if (delimiters.chars.empty()) throw std::invalid_argument("delimiters.chars.empty()");
+
+            for (char ch : delimiters.chars) {
+                auto byte = static_cast<unsigned char>(ch);
+                members[byte / 64] |= 1ULL << (byte % 64);
+            }
+
+            set_size = delimiters.chars.size();
+            std::memcpy(set.data(), delimiters.chars.data(), std::min(set_size, set.size()));
+            if (delimiters.chars.size() == 1) {
+                single = delimiters.chars.front();
+                kind = Kind::Char;
+            }
+        }
+
+        Iterator begin() const noexcept
+        {
+            return Iterator(this, text.empty() ? std::string_view::npos : 0);
+        }
+
+        std::default_sentinel_t end() const noexcept
+        {
+            return std::default_sentinel;
+        }
+
+      private:
+        enum class Kind : int8_t {
+            Char = 1,
+            Sequence = 2,
+            AnyOf = 3
+        };
+
+        /// Returns the position and the length of the next delimiter (npos if there is none).
+        std::pair<std::size_t, std::size_t> find(std::size_t from) const noexcept
+        {
+            switch (kind) {
+                case Kind::Char:
+                    return {text.find(single, from), 1};    // memchr(), vectorized by the C library
+
+                case Kind::Sequence:
+#if defined(__x86_64__)
+                {
+                    static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+                    if (hasAVX2) {
+                        auto at = FindSequenceAVX2(text.substr(from), sequence);
+                        return {at == std::string_view::npos ? at : from + at, sequence.size()};
+                    }
+                }
+#endif
+                    return {text.find(sequence, from), sequence.size()};
+
+                case Kind::AnyOf:
+                    break;
+            }
+
+#if defined(__x86_64__)
+            static const bool hasSSE42 = __builtin_cpu_supports("sse4.2");
+            if (hasSSE42 && set_size <= set.size()) {
+                auto n = text.size() - from;
+                auto at = FindAnyOfSSE42(text.data() + from, n, set.data(), static_cast<int>(set_size));
+                return {at == n ? std::string_view::npos : from + at, 1};
+            }
+#endif
+
+            for (std::size_t i = from; i != text.size(); ++i) {
+                auto byte = static_cast<unsigned char>(text[i]);
+                if (members[byte / 64] & (1ULL << (byte % 64))) return {i, 1};
+            }
+
+            return {std::string_view::npos, 1};
+        }
+
+        using Set = std::array<std::uint64_t, 4>;
+
+        std::string_view text{};
+        std::string_view sequence{};
+        char single = '\0';
+        Kind kind = Kind::Char;
+        bool skip_empty = false;
+        Set members{};                          ///< bitmap of the AnyOf characters
+        std::array<char, 16> set{};             ///< the same characters for SSE4.2 (if they fit)
+        std::size_t set_size = 0;
+    };
+
+
+    /// Splits the text at every occurrence of the character, e.g. Split("a,b,,c", ',') → "a", "b", "", "c".
+    [[maybe_unused]] static SplitView Split(std::string_view text, char delimiter, bool skip_empty = false) noexcept
+    {
+        return {text, delimiter, skip_empty};
+    }
+
+    /// Splits the text at every (non-overlapping) occurrence of the sequence, e.g. Split("a::b", "::") → "a", "b".
+    [[maybe_unused]] static SplitView Split(std::string_view text, std::string_view delimiter, bool skip_empty = false)
+    {
+        return {text, delimiter, skip_empty};
+    }
+
+    /// Splits the text at every character of the set, e.g. Split("a b\tc", AnyOf{" \t"}) → "a", "b", "c".
+    [[maybe_unused]] static SplitView Split(std::string_view text, AnyOf delimiters, bool skip_empty = false)
+    {
+        return {text, delimiters, skip_empty};
+    }
+
+
+    /// Occurrence of a keyword: its index in the list and the position where it starts in the text.
+    struct Match {
+        std::size_t pattern;
+        std::size_t position;
+
+        bool operator==(const Match& rhs) const noexcept = default;
+    };
+
+
+    /// Finds any of many keywords in a single pass over a text (Aho-Corasick), instead of calling Contains() per keyword.
+    /// It is built once into a table of transitions per state and class of bytes (bytes that occur in no keyword share
+    /// one class), so a step costs two lookups whatever the number of keywords. Duplicated keywords are reported once.
+    /// url:https://cr.yp.to/bib/1975/aho.pdf
+    class Keywords final {
+      public:
+        Keywords(std::initializer_list<std::string_view> patterns, bool ignore_case = false): Keywords(std::span(patterns.begin(), patterns.size()), ignore_case)
+        {
+        }
+
+        template<std::ranges::input_range R> requires std::convertible_to<std::ranges::range_reference_t<R>, std::string_view>
+        explicit Keywords(const R& patterns, bool ignore_case = false): folding(ignore_case)
+        {
+            for (std::string_view pattern : patterns) {
+                if (pattern.empty()) throw std::invalid_argument("pattern.empty()");
+                keywords.emplace_back(pattern);
+            }
+
+            build();
+        }
+
+        /// Calls on_match(Match) for every occurrence (overlapping ones included), in the order of their ends.
+        template<typename F>
+        void findAll(std::string_view text, F&& on_match) const
+        {
+            std::uint32_t row = 0;
+
+            for (std::size_t i = 0; i != text.size(); ++i) {
+                if (row == 0) {
+                    while (i != text.size() && !starts[static_cast<unsigned char>(text[i])]) ++i;
+                    if (i == text.size()) return;
+                }
+
+                auto entry = transitions[row + byte_class[static_cast<unsigned char>(text[i])]];
+                row = entry & ~Reports;
+                if ((entry & Reports) == 0) continue;
+
+                for (auto s = report[row / classes]; s != -1; s = dictionary[static_cast<std::size_t>(s)]) {
+                    auto id = static_cast<std::size_t>(output[static_cast<std::size_t>(s)]);
+                    on_match(Match{id, i + 1 - keywords[id].size()});
+                }
+            }
+        }
+
+        [[nodiscard]] std::vector<Match> findAll(std::string_view text) const
+        {
+            std::vector<Match> matches;
+            findAll(text, [&matches](const Match& match) { matches.push_back(match); });
+            return matches;
+        }
+
+        /// The occurrence that ends first (the longest one, if several end there).
+        [[nodiscard]] std::optional<Match> findFirst(std::string_view text) const noexcept
+        {
+            std::uint32_t row = 0;
+
+            for (std::size_t i = 0; i != text.size(); ++i) {
+                auto entry = transitions[row + byte_class[static_cast<unsigned char>(text[i])]];
+                row = entry & ~Reports;
+
+                if (entry & Reports) {
+                    auto id = static_cast<std::size_t>(output[static_cast<std::size_t>(report[row / classes])]);
+                    return Match{id, i + 1 - keywords[id].size()};
+                }
+            }
+
+            return std::nullopt;
+        }
+
+        inline std::size_t size() const noexcept
+        {
+            return keywords.size();
+        }
+
+        inline const std::string& operator[](std::size_t pattern) const noexcept
+        {
+            return keywords[pattern];
+        }
+
+      private:
+        void build()
+        {
+            for (const auto& pattern : keywords) {
+                for (char ch : pattern) {
+                    auto byte = static_cast<unsigned char>(folding ? ToLower(ch) : ch);
+                    if (byte_class[byte] == 0) byte_class[byte] = static_cast<std::uint16_t>(classes++);
+                }
+
+                starts[static_cast<unsigned char>(folding ? ToLower(pattern.front()) : pattern.front())] = true;
+            }
+
+            if (folding) {
+                for (int ch = 'A'; ch <= 'Z'; ++ch) {
+                    byte_class[static_cast<std::size_t>(ch)] = byte_class[static_cast<std::size_t>(ch + 0x20)];
+                    starts[static_cast<std::size_t>(ch)] = starts[static_cast<std::size_t>(ch + 0x20)];
+                }
+            }
+
+            std::vector<std::int32_t> next;
+            auto addState = [this, &next] {
+                next.resize(next.size() + classes, -1);
+                output.push_back(-1);
+                dictionary.push_back(-1);
+                return static_cast<std::int32_t>(output.size() - 1);
+            };
+
+            addState();
+
+            for (std::size_t id = 0; id != keywords.size(); ++id) {
+                std::int32_t state = 0;
+
+                for (char ch : keywords[id]) {
+                    auto at = static_cast<std::size_t>(state) * classes + byte_class[static_cast<unsigned char>(ch)];
+                    if (next[at] == -1) next[at] = addState();    // assigned after the call, which grows the vector
+                    state = next[at];
+                }
+
+                if (output[static_cast<std::size_t>(state)] == -1) output[static_cast<std::size_t>(state)] = static_cast<std::int32_t>(id);
+            }
+
+            // Breadth-first, so the failure state of every state is complete before its transitions are resolved.
+            std::vector<std::int32_t> failure(output.size(), 0);
+            std::deque<std::int32_t> queue{0};
+
+            while (!queue.empty()) {
+                auto state = static_cast<std::size_t>(queue.front());
+                queue.pop_front();
+
+                for (std::size_t c = 0; c != classes; ++c) {
+                    auto& target = next[state * classes + c];
+                    auto fallback = state == 0 ? 0 : next[static_cast<std::size_t>(failure[state]) * classes + c];
+
+                    if (target == -1) {
+                        target = fallback;
+                        continue;
+                    }
+
+                    auto child = static_cast<std::size_t>(target);
+                    failure[child] = fallback;
+                    dictionary[child] = output[static_cast<std::size_t>(fallback)] != -1 ? fallback : dictionary[static_cast<std::size_t>(fallback)];
+                    queue.push_back(target);
+                }
+            }
+
+            if (next.size() > Reports) throw std::length_error("next.size() > Reports");
+
+            for (std::size_t state = 0; state != output.size(); ++state) {
+                report.push_back(output[state] != -1 ? static_cast<std::int32_t>(state) : dictionary[state]);
+            }
+
+            for (auto state : next) {
+                auto row = static_cast<std::uint32_t>(state) * static_cast<std::uint32_t>(classes);
+                transitions.push_back(report[static_cast<std::size_t>(state)] == -1 ? row : row | Reports);
+            }
+        }
+
+        static constexpr std::uint32_t Reports = 1U << 31;    ///< set in a transition to a state with a keyword to report
+
+        std::vector<std::string> keywords{};
+        bool folding;
+        std::array<std::uint16_t, 256> byte_class{};    ///< 0 for the bytes of no keyword
+        std::array<bool, 256> starts{};                 ///< bytes that begin a keyword (skipped to from the initial state)
+        std::size_t classes = 1;
+        std::vector<std::uint32_t> transitions{};       ///< row of a state (state * classes) + class → row of the next state
+        std::vector<std::int32_t> output{};             ///< keyword ending in the state, or -1
+        std::vector<std::int32_t> dictionary{};         ///< nearest state on the failure chain with a keyword, or -1
+        std::vector<std::int32_t> report{};             ///< the state itself if it has a keyword, else its dictionary state
+    };
+
+
+    [[maybe_unused]] static bool Contains(std::string_view source, const Keywords& keywords) noexcept
     {
-        std::regex number("((\\+|-)?[[:digit:]]+)(\\.(([[:digit:]]+)?))?");
-        return std::regex_match(str, number);
+        return keywords.findFirst(source).has_value();
     }
 
 }
@@ -2,54 +2,382 @@
 #define LIBS_TIMESTAMP_HPP
 
 #include <string>
+#include <string_view>
 #include <ctime>
 #include <array>
+#include <algorithm>
+#include <span>
+#include <atomic>
 #include <chrono>
-#include <iomanip>
 #include <locale>
-#include <ranges>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <bit>
+
+#include "./formatting.hpp"
 
 
 namespace hlibs::facilities::timestamp {
 
-    /// Obtains current date and time.
+    struct CivilDate {
+        std::int64_t year;
+        unsigned month;         ///< 1-12
+        unsigned day;           ///< 1-31
+
+        bool operator==(const CivilDate& rhs) const noexcept = default;
+    };
+
+    /// Number of days since 1970-01-01 of a date of the proleptic Gregorian calendar, in integer arithmetic only.
+    /// url:https://howardhinnant.github.io/date_algorithms.html#days_from_civil
+    [[maybe_unused]] static constexpr std::int64_t DaysFromCivil(const CivilDate& date) noexcept
+    {
+        const std::int64_t year = date.year - (date.month <= 2);
+        const std::int64_t era = (year >= 0 ? year : year - 399) / 400;
+        const auto yoe = static_cast<unsigned>(year - era * 400);
+        const unsigned doy = (153 * (date.month > 2 ? date.month - 3 : date.month + 9) + 2) / 5 + date.day - 1;
+        const unsigned doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+        return era * 146097 + static_cast<std::int64_t>(doe) - 719468;
+    }
+
+    /// The inverse of DaysFromCivil().
+    /// url:https://howardhinnant.github.io/date_algorithms.html#civil_from_days
+    [[maybe_unused]] static constexpr CivilDate CivilFromDays(std::int64_t days) noexcept
+    {
+        days += 719468;
+        const std::int64_t era = (days >= 0 ? days : days - 146096) / 146097;
+        const auto doe = static_cast<unsigned>(days - era * 146097);
+        const unsigned yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+        const unsigned doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+        const unsigned mp = (5 * doy + 2) / 153;
+        const unsigned day = doy - (153 * mp + 2) / 5 + 1;
+        const unsigned month = mp < 10 ? mp + 3 : mp - 9;
+        return {static_cast<std::int64_t>(yoe) + era * 400 + (month <= 2), month, day};
+    }
+
+    /// Offset of the local time zone from UTC at the moment. Time zones change their offsets only at quarters of an hour,
+    /// so localtime_r() is asked once per quarter; the answer is shared by all threads through a single atomic word.
+    [[maybe_unused]] static std::chrono::seconds UtcOffset(std::chrono::sys_seconds moment) noexcept
+    {
+        constexpr std::int64_t Quarter = 15 * 60;
+        constexpr unsigned Bits = 20;                   ///< low bits of the cache: offset + Bias (offsets are within ±18 h)
+        constexpr std::int64_t Bias = 1L << (Bits - 1);
+        static std::atomic<std::uint64_t> cache = 0;    ///< (quarter + 1) << Bits | (offset + Bias); 0 when empty
+
+        const auto seconds = moment.time_since_epoch().count();
+        const auto quarter = static_cast<std::uint64_t>(seconds / Quarter + 1);
+
+        if (auto entry = cache.load(std::memory_order_relaxed); seconds >= 0 && entry >> Bits == quarter) {
+            return std::chrono::seconds(static_cast<std::int64_t>(entry & ((1UL << Bits) - 1)) - Bias);
+        }
+
+        const std::time_t time = seconds;
+        std::tm local{};
+        if (localtime_r(&time, &local) == nullptr) return std::chrono::seconds(0);
+
+        const std::int64_t offset = local.tm_gmtoff;
+        if (seconds >= 0) cache.store(quarter << Bits | static_cast<std::uint64_t>(offset + Bias), std::memory_order_relaxed);
+        return std::chrono::seconds(offset);
+    }
+
+
+    /// Digits of the fraction of a second written by DateTime::iso8601().
+    enum class Precision : int8_t {
+        Seconds = 0,
+        Milliseconds = 3,
+        Microseconds = 6,
+        Nanoseconds = 9
+    };
+
+
+    /// Obtains current date and time (local). It is computed from the clock with integer arithmetic and UtcOffset(), without
+    /// std::localtime() or streams, so it may be created from many threads at once.
     struct DateTime {
-        /// url:https://en.cppreference.com/w/cpp/locale/locale
-        explicit DateTime(const std::locale& locale = std::locale::classic())
+        using Clock = std::chrono::system_clock;
+
+        /// Length of the longest iso8601() text: "YYYY-mm-ddTHH:MM:SS.nnnnnnnnn+hh:mm".
+        static constexpr std::size_t MaxLength = 35;
+
+        DateTime(): DateTime(Clock::now())
         {
-            auto now = std::chrono::system_clock::to_time_t(std::chrono::system_clock::now());
-            std::tm current = *std::localtime(&now);
+        }
 
-            std::ostringstream ss;
-            ss.imbue(std::locale(locale));
-            ss << std::put_time(&current, "%Y-%m-%d %H:%M:%S");
-            auto str = ss.str();
+        /// The formats consist of digits and ASCII separators only, which are the same in every locale.
+        explicit DateTime(const std::locale& locale): DateTime()
+        {
+            static_cast<void>(locale);
+        }
+
+        explicit DateTime(Clock::time_point moment): point(moment), offset(UtcOffset(std::chrono::floor<std::chrono::seconds>(moment)))
+        {
+            const auto local = std::chrono::floor<std::chrono::seconds>(moment).time_since_epoch() + offset;
+            const auto days = std::chrono::floor<std::chrono::days>(local);
+            const auto civil = CivilFromDays(days.count());
+            const auto clock = static_cast<std::uint64_t>((local - days).count());
 
-            auto delimiter = str.find_first_of(' ');
-            date = str.substr(0, delimiter);
-            time = str.substr(delimiter + 1);
+            std::array<char, 10> buffer{};
+            WriteDigits(buffer.data(), static_cast<std::uint64_t>(civil.year), 4);
+            buffer[4] = buffer[7] = '-';
+            WriteDigits(buffer.data() + 5, civil.month, 2);
+            WriteDigits(buffer.data() + 8, civil.day, 2);
+            date.assign(buffer.data(), 10);
+
+            WriteDigits(buffer.data(), clock / 3600, 2);
+            buffer[2] = buffer[5] = ':';
+            WriteDigits(buffer.data() + 3, clock / 60 % 60, 2);
+            WriteDigits(buffer.data() + 6, clock % 60, 2);
+            time.assign(buffer.data(), 8);
         }
 
         /// "YYYY-mm-dd HH:MM:SS"
         [[nodiscard]] std::string timestamp() const noexcept
         {
-            return date + ' ' + time;
+            formatting::StringBuilder<32> builder;
+            builder << date << ' ' << time;
+            return builder.str();
         }
 
         /// "YYYYmmDD_HHMMSS"
         [[nodiscard]] std::string filestamp() const noexcept
         {
-            std::string ymd;
-            std::string hm;
-            std::ranges::remove_copy(date, std::back_inserter(ymd), '-');
-            std::ranges::remove_copy(time, std::back_inserter(hm), ':');
-            return ymd + '_' + hm;
+            formatting::StringBuilder<32> builder;
+            for (char ch : date) if (ch != '-') builder.append(ch);
+            builder.append('_');
+            for (char ch : time) if (ch != ':') builder.append(ch);
+            return builder.str();
+        }
+
+        /// Writes "YYYY-mm-ddTHH:MM:SS[.f…]±hh:mm" (ISO 8601) into the target (without allocating); returns its length.
+        std::size_t iso8601(std::span<char> target, Precision precision = Precision::Seconds) const
+        {
+            const auto digits = static_cast<std::size_t>(precision);
+            const std::size_t length = 19 + (digits != 0 ? digits + 1 : 0) + 6;
+            if (target.size() < length) throw std::length_error("target.size() < length");
+
+            char* out = target.data();
+            out = std::copy(date.begin(), date.end(), out);
+            *out++ = 'T';
+            out = std::copy(time.begin(), time.end(), out);
+
+            if (digits != 0) {
+                auto nanoseconds = std::chrono::duration_cast<std::chrono::nanoseconds>(point - std::chrono::floor<std::chrono::seconds>(point)).count();
+                for (auto i = digits; i != 9; ++i) nanoseconds /= 10;
+                *out++ = '.';
+                out = WriteDigits(out, static_cast<std::uint64_t>(nanoseconds), digits);
+            }
+
+            const auto minutes = offset.count() / 60;
+            *out++ = minutes < 0 ? '-' : '+';
+            out = WriteDigits(out, static_cast<std::uint64_t>(minutes < 0 ? -minutes : minutes) / 60, 2);
+            *out++ = ':';
+            WriteDigits(out, static_cast<std::uint64_t>(minutes < 0 ? -minutes : minutes) % 60, 2);
+            return length;
         }
 
-        std::string date;    ///< "YYYY-mm-dd"
-        std::string time;    ///< "HH:MM:SS"
+        [[nodiscard]] std::string iso8601(Precision precision = Precision::Seconds) const
+        {
+            std::array<char, MaxLength> buffer{};
+            return {buffer.data(), iso8601(buffer, precision)};
+        }
+
+        std::string date;               ///< "YYYY-mm-dd"
+        std::string time;               ///< "HH:MM:SS"
+        Clock::time_point point;        ///< the moment itself
+        std::chrono::seconds offset;    ///< of the local time from UTC
+
+      private:
+        /// Writes the lowest width decimal digits of the value, padded with zeros; returns the end.
+        static char* WriteDigits(char* out, std::uint64_t value, std::size_t width) noexcept
+        {
+            for (auto i = width; i != 0; --i, value /= 10) out[i - 1] = static_cast<char>('0' + value % 10);
+            return out + width;
+        }
     };
 
+
+    /// Layout of 8 characters for the SWAR parsers: 'd' is a digit, '?' any character, anything else itself.
+    struct Layout {
+        std::uint64_t mask;         ///< bits compared: the high nibble of a digit, the whole of a separator
+        std::uint64_t expected;     ///< their values
+        std::uint64_t digits;       ///< 0xFF at the digits
+
+        static constexpr Layout Of(std::string_view pattern) noexcept
+        {
+            Layout layout{0, 0, 0};
+
+            for (unsigned i = 0; i != 8; ++i) {
+                const unsigned shift = 8 * i;
+                const auto ch = static_cast<std::uint64_t>(static_cast<unsigned char>(pattern[i]));
+
+                if (pattern[i] == 'd') {
+                    layout.mask |= 0xF0ULL << shift;
+                    layout.expected |= 0x30ULL << shift;
+                    layout.digits |= 0xFFULL << shift;
+                } else if (pattern[i] != '?') {
+                    layout.mask |= 0xFFULL << shift;
+                    layout.expected |= ch << shift;
+                }
+            }
+
+            return layout;
+        }
+    };
+
+    /// Loads 8 characters as a word with the first one in the lowest byte.
+    [[maybe_unused]] static std::uint64_t Load8(const char* text) noexcept
+    {
+        std::uint64_t word = 0;
+        std::memcpy(&word, text, sizeof(word));
+        if constexpr (std::endian::native == std::endian::big) word = __builtin_bswap64(word);
+        return word;
+    }
+
+    /// Checks 8 characters against the layout at once (SWAR); returns the values of the digits (0 elsewhere), or nullopt.
+    /// A digit has the high nibble 3 and stays below 0x40 after adding 6.
+    [[maybe_unused]] static constexpr std::optional<std::uint64_t> MatchLayout(std::uint64_t word, const Layout& layout) noexcept
+    {
+        if ((word & layout.mask) != layout.expected) return std::nullopt;
+        if (((word + (layout.digits & 0x0606060606060606ULL)) & layout.mask & layout.digits) != (layout.expected & layout.digits)) return std::nullopt;
+        return word & layout.digits & 0x0F0F0F0F0F0F0F0FULL;
+    }
+
+    /// The two-digit number starting at character i of the values (10 × digit i + digit i + 1).
+    [[maybe_unused]] static constexpr unsigned PairAt(std::uint64_t values, unsigned i) noexcept
+    {
+        return static_cast<unsigned>(((values * 10 + (values >> 8)) >> (8 * i)) & 0xFF);
+    }
+
+    [[maybe_unused]] static constexpr unsigned LastDay(std::int64_t year, unsigned month) noexcept
+    {
+        if (month != 2) return 30 + ((month + (month >> 3)) & 1);
+        return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0)) ? 29 : 28;
+    }
+
+    /// The moment of the fields of a date and time, or nullopt if any of them is out of its range.
+    [[maybe_unused]] static constexpr std::optional<std::chrono::sys_seconds> ComposeTime(const CivilDate& date, unsigned hour, unsigned minute, unsigned second) noexcept
+    {
+        if (date.month - 1 >= 12 || date.day - 1 >= LastDay(date.year, date.month)) return std::nullopt;
+        if (hour >= 24 || minute >= 60 || second >= 60) return std::nullopt;
+
+        const auto days = std::chrono::sys_days(std::chrono::days(DaysFromCivil(date)));
+        return days + std::chrono::hours(hour) + std::chrono::minutes(minute) + std::chrono::seconds(second);
+    }
+
+    /// Parses "YYYY-mm-dd HH:MM:SS" (DateTime::timestamp()); the time is taken as offset from UTC (e.g. DateTime::offset
+    /// for the local time of the logs). nullopt if the text is anything else or not a valid date and time.
+    [[maybe_unused]] static std::optional<std::chrono::sys_seconds> ParseTimestamp(std::string_view text, std::chrono::seconds offset = std::chrono::seconds(0)) noexcept
+    {
+        static constexpr auto Date = Layout::Of("dddd-dd-");
+        static constexpr auto Day = Layout::Of("dd dd:dd");
+        static constexpr auto Time = Layout::Of("dd:dd:dd");
+
+        if (text.size() != 19) return std::nullopt;
+        const auto date = MatchLayout(Load8(text.data()), Date);
+        const auto day = MatchLayout(Load8(text.data() + 8), Day);
+        const auto time = MatchLayout(Load8(text.data() + 11), Time);
+        if (!date || !day || !time) return std::nullopt;
+
+        const CivilDate civil{PairAt(*date, 0) * 100 + PairAt(*date, 2), PairAt(*date, 5), PairAt(*day, 0)};
+        auto moment = ComposeTime(civil, PairAt(*time, 0), PairAt(*time, 3), PairAt(*time, 6));
+        return moment ? std::optional(*moment - offset) : std::nullopt;
+    }
+
+    /// Parses "YYYYmmDD_HHMMSS" (DateTime::filestamp()), like ParseTimestamp().
+    [[maybe_unused]] static std::optional<std::chrono::sys_seconds> ParseFilestamp(std::string_view text, std::chrono::seconds offset = std::chrono::seconds(0)) noexcept
+    {
+        static constexpr auto Date = Layout::Of("dddddddd");
+        static constexpr auto Time = Layout::Of("d_dddddd");
+
+        if (text.size() != 15) return std::nullopt;
+        const auto date = MatchLayout(Load8(text.data()), Date);
+        const auto time = MatchLayout(Load8(text.data() + 7), Time);
+        if (!date || !time) return std::nullopt;
+
+        const CivilDate civil{PairAt(*date, 0) * 100 + PairAt(*date, 2), PairAt(*date, 4), PairAt(*date, 6)};
+        auto moment = ComposeTime(civil, PairAt(*time, 2), PairAt(*time, 4), PairAt(*time, 6));
+        return moment ? std::optional(*moment - offset) : std::nullopt;
+    }
+
+    /// Parses "YYYY-mm-ddTHH:MM:SS[.f…][Z|±hh:mm|±hhmm]" (DateTime::iso8601(), 'T' may also be ' '); digits of the fraction
+    /// beyond nanoseconds are ignored, and a time without a zone is taken as UTC.
+    [[maybe_unused]] static std::optional<std::chrono::sys_time<std::chrono::nanoseconds>> ParseISO8601(std::string_view text) noexcept
+    {
+        static constexpr auto Date = Layout::Of("dddd-dd-");
+        static constexpr auto Day = Layout::Of("dd?dd:dd");
+        static constexpr auto Time = Layout::Of("dd:dd:dd");
+
+        if (text.size() < 19 || (text[10] != 'T' && text[10] != ' ')) return std::nullopt;
+        const auto date = MatchLayout(Load8(text.data()), Date);
+        const auto day = MatchLayout(Load8(text.data() + 8), Day);
+        const auto time = MatchLayout(Load8(text.data() + 11), Time);
+        if (!date || !day || !time) return std::nullopt;
+
+        const CivilDate civil{PairAt(*date, 0) * 100 + PairAt(*date, 2), PairAt(*date, 5), PairAt(*day, 0)};
+        const auto moment = ComposeTime(civil, PairAt(*time, 0), PairAt(*time, 3), PairAt(*time, 6));
+        if (!moment) return std::nullopt;
+
+        std::size_t i = 19;
+        std::int64_t fraction = 0;
+
+        if (i != text.size() && text[i] == '.') {
+            const auto first = ++i;
+            for (; i != text.size() && static_cast<unsigned char>(text[i] - '0') < 10; ++i) {
+                if (i - first < 9) fraction = fraction * 10 + (text[i] - '0');
+            }
+            if (i == first) return std::nullopt;
+            for (auto digits = i - first; digits < 9; ++digits) fraction *= 10;
+        }
+
+        std::chrono::minutes offset(0);
+
+        if (i != text.size() && text[i] == 'Z') {
+            ++i;
+        } else if (i != text.size() && (text[i] == '+' || text[i] == '-')) {
+            const auto zone = text.substr(i + 1);
+            const bool colon = zone.size() == 5 && zone[2] == ':';
+            if (zone.size() != (colon ? 5U : 4U)) return std::nullopt;
+
+            const std::array<char, 8> digits{zone[0], zone[1], zone[colon ? 3U : 2U], zone[colon ? 4U : 3U], '0', '0', '0', '0'};
+            const auto values = MatchLayout(Load8(digits.data()), Layout::Of("dddddddd"));
+            if (!values || PairAt(*values, 0) >= 24 || PairAt(*values, 2) >= 60) return std::nullopt;
+
+            offset = std::chrono::hours(PairAt(*values, 0)) + std::chrono::minutes(PairAt(*values, 2));
+            if (text[i] == '-') offset = -offset;
+            i = text.size();
+        }
+
+        if (i != text.size()) return std::nullopt;
+        return *moment + std::chrono::nanoseconds(fraction) - offset;
+    }
+
+    /// Parses the column into the target; returns the number of entries parsed (less than column.size() if one is invalid).
+    [[maybe_unused]] static std::size_t ParseTimestamp(std::span<const std::string_view> column, std::span<std::chrono::sys_seconds> target, std::chrono::seconds offset = std::chrono::seconds(0))
+    {
+        if (target.size() < column.size()) throw std::length_error("target.size() < column.size()");
+
+        for (std::size_t i = 0; i != column.size(); ++i) {
+            auto moment = ParseTimestamp(column[i], offset);
+            if (!moment) return i;
+            target[i] = *moment;
+        }
+
+        return column.size();
+    }
+
+    [[maybe_unused]] static std::size_t ParseISO8601(std::span<const std::string_view> column, std::span<std::chrono::sys_time<std::chrono::nanoseconds>> target)
+    {
+        if (target.size() < column.size()) throw std::length_error("target.size() < column.size()");
+
+        for (std::size_t i = 0; i != column.size(); ++i) {
+            auto moment = ParseISO8601(column[i]);
+            if (!moment) return i;
+            target[i] = *moment;
+        }
+
+        return column.size();
+    }
+
 }
 
 #endif //LIBS_TIMESTAMP_HPP
@@ -0,0 +1,487 @@
+#ifndef LIBS_CSV_HPP
+#define LIBS_CSV_HPP
+
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <filesystem>
+#include <sstream>
+#include <iomanip>
+#include <charconv>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+
+namespace hlibs::io {
+
+    /// Streams a delimited text file row-by-row (RFC 4180 quoting, LF or CRLF line breaks).
+    /// Fields are views into the internal buffer and stay valid until the next call of getNextRow().
+    class CSVReader final {
+      public:
+        explicit CSVReader(const std::filesystem::path& p, char delimiter = ',', bool skip_header = true, std::size_t capacity = 1UL << 20)
+                : path(p), file(p, std::ios::in | std::ios::binary), separator(delimiter), buffer(std::max<std::size_t>(capacity, 64) + 1)
+        {
+            if (file.fail() || !file.is_open()) {
+                file.close();
+                throw std::ios::failure("file.fail() || !file.is_open()");
+            }
+
+            if (separator == '"' || separator == '\n' || separator == '\r') throw std::invalid_argument("separator");
+            if (skip_header && hasNextRow()) readHeader();
+        }
+
+        CSVReader(const CSVReader& rhs) = delete;
+        CSVReader& operator=(const CSVReader& rhs) = delete;
+
+        CSVReader(CSVReader&& rhs) noexcept = delete;
+        CSVReader& operator=(CSVReader&& rhs) noexcept = delete;
+
+        ~CSVReader() noexcept = default;
+
+        bool hasNextRow()
+        {
+            if (head == tail && !eof) refill();
+            return head < tail;
+        }
+
+        /// Only the selected columns (all by default) are materialized, in the order of selection.
+        const std::vector<std::string_view>& getNextRow()
+        {
+            std::size_t next;
+
+            while ((next = scanRow()) == npos) {
+                if (!eof) {
+                    refill();
+                    continue;
+                }
+
+                if (terminated) throw std::ios::failure("unterminated quoted field");
+                buffer[tail++] = '\n';    // the spare byte closes the last row
+                terminated = true;
+            }
+
+            materialize();
+            head = next;
+            ++rows_read;
+            return row;
+        }
+
+        /// Projects rows onto the given column indices; an empty list selects all columns.
+        void select(std::vector<std::size_t> indices)
+        {
+            selection = std::move(indices);
+            slots.clear();
+
+            for (std::size_t i = 0; i != selection.size(); ++i) {
+                if (selection[i] >= slots.size()) slots.resize(selection[i] + 1, npos);
+                slots[selection[i]] = i;
+            }
+        }
+
+        /// Projects rows onto columns named in the skipped header.
+        void select(const std::vector<std::string_view>& names)
+        {
+            std::vector<std::size_t> indices;
+
+            for (auto name : names) {
+                auto it = std::ranges::find(names_of_columns, name);
+                if (it == names_of_columns.end()) throw std::invalid_argument("!header().contains(name)");
+                indices.push_back(static_cast<std::size_t>(it - names_of_columns.begin()));
+            }
+
+            select(std::move(indices));
+        }
+
+        inline const std::vector<std::string>& header() const noexcept
+        {
+            return names_of_columns;
+        }
+
+        inline std::size_t rows() const noexcept
+        {
+            return rows_read;
+        }
+
+        /// {"$Path","$FileAddress","$NumberOfRowsRead"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            std::stringstream ss;
+            ss << '{';
+            ss << '"' << path.string() << "\",";
+            ss << '"' << &file << "\",";
+            ss << std::quoted(std::to_string(rows_read));
+            ss << '}';
+            return ss.str();
+        }
+
+      private:
+        struct Field {
+            std::size_t begin;
+            std::size_t end;
+            bool escaped;
+        };
+
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+
+        void readHeader()
+        {
+            for (auto name : getNextRow()) names_of_columns.emplace_back(name);
+            rows_read = 0;
+        }
+
+        void refill()
+        {
+            if (head != 0) {
+                std::memmove(buffer.data(), buffer.data() + head, tail - head);
+                tail -= head;
+                head = 0;
+            }
+
+            if (tail == buffer.size() - 1) buffer.resize(2 * buffer.size());
+
+            file.read(buffer.data() + tail, static_cast<std::streamsize>(buffer.size() - 1 - tail));
+            auto count = static_cast<std::size_t>(file.gcount());
+            tail += count;
+            if (count == 0) eof = true;
+        }
+
+        /// Finds the end of the row starting at head, recording the selected fields; npos when the row is incomplete.
+        std::size_t scanRow()
+        {
+            const char* data = buffer.data();
+            std::size_t column = 0;
+            std::size_t start = head;
+            std::size_t i = head;
+            bool quoted = false;
+            bool escaped = false;
+            fields.assign(selection.empty() ? 0 : selection.size(), Field{0, 0, false});
+
+            while (true) {
+                i = quoted ? FindQuote(data, i, tail) : FindSpecial(data, i, tail, separator);
+                if (i == tail) return npos;
+
+                if (quoted) {
+                    if (i + 1 == tail) return npos;
+
+                    if (data[i + 1] == '"') {
+                        escaped = true;
+                        i += 2;
+                    }
+                    else {
+                        quoted = false;
+                        ++i;
+                    }
+
+                    continue;
+                }
+
+                if (data[i] == '"') {
+                    quoted = true;
+                    ++i;
+                    continue;
+                }
+
+                std::size_t end = i;
+                if (data[i] == '\n' && end > start && data[end - 1] == '\r') --end;
+                record(column++, Field{start, end, escaped});
+                escaped = false;
+
+                if (data[i] == '\n') return i + 1;
+                start = ++i;
+            }
+        }
+
+        void record(std::size_t column, Field field)
+        {
+            if (selection.empty()) {
+                fields.push_back(field);
+                return;
+            }
+
+            if (column < slots.size() && slots[column] != npos) fields[slots[column]] = field;
+        }
+
+        /// Strips the enclosing quotes and collapses doubled ones in place.
+        void materialize()
+        {
+            row.clear();
+
+            for (auto [begin, end, escaped] : fields) {
+                char* data = buffer.data();
+
+                if (end - begin >= 2 && data[begin] == '"' && data[end - 1] == '"') {
+                    ++begin;
+                    --end;
+                }
+
+                if (escaped) {
+                    std::size_t out = begin;
+
+                    for (std::size_t in = begin; in != end; ++in, ++out) {
+                        data[out] = data[in];
+                        if (data[in] == '"' && in + 1 != end && data[in + 1] == '"') ++in;
+                    }
+
+                    end = out;
+                }
+
+                row.emplace_back(data + begin, end - begin);
+            }
+        }
+
+        static std::size_t FindQuote(const char* data, std::size_t from, std::size_t to) noexcept
+        {
+            const void* found = std::memchr(data + from, '"', to - from);
+            return found == nullptr ? to : static_cast<std::size_t>(static_cast<const char*>(found) - data);
+        }
+
+        /// Bitmask scan for the separator, a quote or a line feed, 16 bytes per step.
+        static std::size_t FindSpecial(const char* data, std::size_t from, std::size_t to, char sep) noexcept
+        {
+            std::size_t i = from;
+
+#if defined(__SSE2__)
+            const __m128i separators = _mm_set1_epi8(sep);
+            const __m128i quotes = _mm_set1_epi8('"');
+            const __m128i newlines = _mm_set1_epi8('\n');
+
+            for (; i + 16 <= to; i += 16) {
+                __m128i block = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + i));
+                __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(block, separators), _mm_or_si128(_mm_cmpeq_epi8(block, quotes), _mm_cmpeq_epi8(block, newlines)));
+                auto mask = static_cast<unsigned>(_mm_movemask_epi8(hits));
+                if (mask != 0) return i + static_cast<std::size_t>(__builtin_ctz(mask));
+            }
+#endif
+
+            for (; i != to; ++i) {
+                if (data[i] == sep || data[i] == '"' || data[i] == '\n') return i;
+            }
+
+            return to;
+        }
+
+        std::filesystem::path path;
+        std::ifstream file;
+        char separator;
+        std::vector<char> buffer;
+        std::size_t head = 0;
+        std::size_t tail = 0;
+        bool eof = false;
+        bool terminated = false;
+        std::vector<std::string> names_of_columns{};
+        std::vector<std::size_t> selection{};
+        std::vector<std::size_t> slots{};
+        std::vector<Field> fields{};
+        std::vector<std::string_view> row{};
+        std::size_t rows_read = 0;
+    };
+
+
+    /// Writes delimited rows through a large in-memory buffer (numbers are formatted with std::to_chars).
+    class CSVWriter final {
+      public:
+        explicit CSVWriter(const std::filesystem::path& p, char delimiter = ',', std::size_t capacity = 1UL << 20)
+                : path(p), file(p, std::ios::out | std::ios::trunc | std::ios::binary), separator(delimiter), buffer(std::max<std::size_t>(capacity, 64))
+        {
+            if (!file.is_open() || !file.good()) {
+                file.close();
+                throw std::ios_base::failure("!file.is_open() || !file.good()");
+            }
+
+            file.exceptions(std::ofstream::badbit);
+        }
+
+        CSVWriter(const CSVWriter& rhs) = delete;
+        CSVWriter& operator=(const CSVWriter& rhs) = delete;
+
+        CSVWriter(CSVWriter&& rhs) noexcept = delete;
+        CSVWriter& operator=(CSVWriter&& rhs) noexcept = delete;
+
+        ~CSVWriter() noexcept
+        {
+            try {
+                sync();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "~CSVWriter->exception: " << e.what();
+            }
+        }
+
+        /// Quotes the text only when it holds the separator, a quote, or a line break.
+        void field(std::string_view text)
+        {
+            delimit();
+
+            auto isSpecial = [this](char ch) {
+                return ch == separator || ch == '"' || ch == '\r' || ch == '\n';
+            };
+
+            if (std::ranges::none_of(text, isSpecial)) {
+                append(text);
+                return;
+            }
+
+            append("\"");
+
+            for (auto quote = text.find('"'); quote != std::string_view::npos; quote = text.find('"')) {
+                append(text.substr(0, quote + 1));
+                append("\"");
+                text.remove_prefix(quote + 1);
+            }
+
+            append(text);
+            append("\"");
+        }
+
+        void field(const char* text)
+        {
+            field(std::string_view(text));
+        }
+
+        template<typename T>
+        requires std::numeric_limits<T>::is_integer && (!std::is_same_v<T, bool>)
+        void field(T integer)
+        {
+            delimit();
+            reserve(std::numeric_limits<T>::digits10 + 3);
+            auto [end, ec] = std::to_chars(buffer.data() + used, buffer.data() + buffer.size(), integer);
+            used = static_cast<std::size_t>(end - buffer.data());
+        }
+
+        /// Shortest round-trip representation, or fixed notation of the given precision.
+        template<typename T>
+        requires std::is_floating_point_v<T>
+        void field(T number, int precision = -1)
+        {
+            delimit();
+            reserve(64);
+            char* first = buffer.data() + used;
+            char* last = buffer.data() + buffer.size();
+            std::to_chars_result result{};
+
+            if (precision < 0) {
+                result = std::to_chars(first, last, number);
+            }
+            else {
+                result = std::to_chars(first, last, number, std::chars_format::fixed, precision);
+            }
+
+            if (result.ec == std::errc::value_too_large) {
+                // fixed notation of a large value: sign, all integral digits, the point, and the fraction
+                reserve(static_cast<std::size_t>(std::numeric_limits<T>::max_exponent10 + precision + 3));
+                first = buffer.data() + used;
+                last = buffer.data() + buffer.size();
+                result = std::to_chars(first, last, number, std::chars_format::fixed, precision);
+            }
+
+            if (result.ec != std::errc()) throw std::invalid_argument("to_chars() of a floating-point field");
+
+            used = static_cast<std::size_t>(result.ptr - buffer.data());
+        }
+
+        void field(bool b)
+        {
+            delimit();
+            append(b ? "true" : "false");
+        }
+
+        template<typename... Ts>
+        void row(const Ts&... values)
+        {
+            (field(values), ...);
+            endRow();
+        }
+
+        void endRow()
+        {
+            append("\n");
+            first_in_row = true;
+            ++rows_written;
+        }
+
+        inline void sync()
+        {
+            if (used != 0) file.write(buffer.data(), static_cast<std::streamsize>(used));
+            bytes_written += used;
+            used = 0;
+            file.flush();
+        }
+
+        /// Bytes passed to the file so far, including the ones still buffered.
+        inline std::size_t bytes() const noexcept
+        {
+            return bytes_written + used;
+        }
+
+        inline std::size_t rows() const noexcept
+        {
+            return rows_written;
+        }
+
+        /// {"$Path","$FileAddress","$BytesWritten"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            std::stringstream ss;
+            ss << '{';
+            ss << std::quoted(path.string()) << ',';
+            ss << '"' << &file << "\",";
+            ss << std::quoted(std::to_string(bytes()));
+            ss << '}';
+            return ss.str();
+        }
+
+      private:
+        void delimit()
+        {
+            if (!first_in_row) append(std::string_view(&separator, 1));
+            first_in_row = false;
+        }
+
+        void reserve(std::size_t count)
+        {
+            if (buffer.size() - used < count) drain();
+            if (buffer.size() < count) buffer.resize(count);
+        }
+
+        void drain()
+        {
+            file.write(buffer.data(), static_cast<std::streamsize>(used));
+            bytes_written += used;
+            used = 0;
+        }
+
+        void append(std::string_view text)
+        {
+            if (buffer.size() - used < text.size()) drain();
+
+            if (text.size() > buffer.size()) {
+                file.write(text.data(), static_cast<std::streamsize>(text.size()));
+                bytes_written += text.size();
+                return;
+            }
+
+            std::memcpy(buffer.data() + used, text.data(), text.size());
+            used += text.size();
+        }
+
+        std::filesystem::path path;
+        std::ofstream file;
+        char separator;
+        std::vector<char> buffer;
+        std::size_t used = 0;
+        std::size_t bytes_written = 0;
+        std::size_t rows_written = 0;
+        bool first_in_row = true;
+    };
+
+}
+
+#endif //LIBS_CSV_HPP
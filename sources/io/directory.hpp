@@ -0,0 +1,297 @@
+#ifndef LIBS_DIRECTORY_HPP
+#define LIBS_DIRECTORY_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <filesystem>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <iomanip>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <dirent.h>
+#include <unistd.h>
+
+#include "./helper_objects.hpp"
+
+
+namespace hlibs::io {
+
+    /// Metadata of one entry, handed to the callback of DirectoryScanner::scan().
+    struct DirectoryEntry {
+        int directory;                  ///< descriptor of the parent, valid during the callback only (for *at() calls)
+        std::string_view name;          ///< valid during the callback only
+        std::size_t depth;              ///< 1 for the entries of the root
+        std::filesystem::file_type type;
+        std::uint64_t size;             ///< as reported by GetFileSize()
+        std::uint64_t allocated;        ///< bytes of allocated blocks
+        std::chrono::system_clock::time_point modified;
+    };
+
+
+    /// Totals of the tree below the root (the root itself excluded); both sizes sum regular files only (the blocks of
+    /// directories are not counted, so that they need no statx() call).
+    struct DirectoryUsage {
+        std::uint64_t bytes = 0;
+        std::uint64_t allocated = 0;
+        std::uint64_t files = 0;
+        std::uint64_t directories = 0;
+        std::uint64_t others = 0;
+        std::uint64_t errors = 0;       ///< entries or directories that could not be read
+
+        DirectoryUsage& operator+=(const DirectoryUsage& rhs) noexcept
+        {
+            bytes += rhs.bytes;
+            allocated += rhs.allocated;
+            files += rhs.files;
+            directories += rhs.directories;
+            others += rhs.others;
+            errors += rhs.errors;
+            return *this;
+        }
+
+        /// {"$Bytes","$Files","$Directories","$Others","$Errors"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            std::stringstream ss;
+            ss << '{';
+            ss << std::quoted(std::to_string(bytes)) << ',';
+            ss << std::quoted(std::to_string(files)) << ',';
+            ss << std::quoted(std::to_string(directories)) << ',';
+            ss << std::quoted(std::to_string(others)) << ',';
+            ss << std::quoted(std::to_string(errors));
+            ss << '}';
+            return ss.str();
+        }
+    };
+
+
+    /// Walks a directory tree with getdents64() and statx() relative to directory descriptors, spreading subtrees over
+    /// a pool of threads. Symbolic links are reported, but not followed.
+    class DirectoryScanner final {
+      public:
+        using Visitor = std::function<void(const DirectoryEntry&)>;
+
+        explicit DirectoryScanner(std::size_t threads = std::max(1U, std::thread::hardware_concurrency()))
+                : workers(std::max<std::size_t>(threads, 1))
+        {
+        }
+
+        /// The visitor, if given, is called concurrently from the worker threads for every entry. If it throws, the other
+        /// workers stop at their next directory and the first exception is rethrown here.
+        DirectoryUsage scan(const std::filesystem::path& root, const Visitor& visit = {}) const
+        {
+            if (!std::filesystem::is_directory(root)) throw std::invalid_argument("!is_directory(root)");
+
+            Shared shared{};
+            shared.pending.push_back(Pending{nullptr, root.string(), 0});
+            std::vector<DirectoryUsage> partial(workers);
+
+            {
+                std::vector<std::jthread> pool;
+                pool.reserve(workers);
+
+                for (std::size_t i = 0; i != workers; ++i) {
+                    pool.emplace_back([&shared, &visit, &usage = partial[i]] { Work(shared, visit, usage); });
+                }
+            }
+
+            if (shared.failure) std::rethrow_exception(shared.failure);
+
+            DirectoryUsage total{};
+            for (const auto& usage : partial) total += usage;
+            return total;
+        }
+
+        /// {"$NumberOfThreads"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            return "{\"" + std::to_string(workers) + "\"}";
+        }
+
+      private:
+        /// A directory yet to be read: its name is relative to the parent (kept open until the children are opened).
+        struct Pending {
+            std::shared_ptr<FileDescriptor> parent;
+            std::string name;
+            std::size_t depth;
+        };
+
+        struct Shared {
+            std::mutex mutex;
+            std::condition_variable wakeup;
+            std::deque<Pending> pending;
+            std::size_t busy = 0;
+            std::atomic<std::size_t> idle = 0;
+            std::atomic<bool> stopped = false;
+            std::exception_ptr failure{};       ///< the first exception of a worker, guarded by the mutex
+        };
+
+        /// url:https://man7.org/linux/man-pages/man2/getdents.2.html
+        struct LinuxDirent64 {
+            ino64_t d_ino;
+            off64_t d_off;
+            unsigned short d_reclen;
+            unsigned char d_type;
+            char d_name[1];
+        };
+
+        /// Depth-first on a private stack; half of it is handed over whenever another worker is idle.
+        static void Work(Shared& shared, const Visitor& visit, DirectoryUsage& usage)
+        {
+            std::vector<Pending> local;
+            std::vector<char> buffer(1UL << 16);
+
+            while (!shared.stopped.load(std::memory_order_relaxed)) {
+                if (local.empty()) {
+                    std::unique_lock lock(shared.mutex);
+                    ++shared.idle;
+                    shared.wakeup.wait(lock, [&shared] { return !shared.pending.empty() || shared.busy == 0 || shared.stopped; });
+                    --shared.idle;
+
+                    if (shared.pending.empty() || shared.stopped) {
+                        shared.wakeup.notify_all();
+                        return;
+                    }
+
+                    local.push_back(std::move(shared.pending.front()));
+                    shared.pending.pop_front();
+                    ++shared.busy;
+                }
+
+                auto item = std::move(local.back());
+                local.pop_back();
+
+                try {
+                    Read(item, buffer, local, visit, usage);
+                }
+                catch (...) {
+                    std::scoped_lock lock(shared.mutex);
+                    if (!shared.failure) shared.failure = std::current_exception();
+                    shared.stopped = true;
+                    shared.wakeup.notify_all();
+                    return;
+                }
+
+                if (local.size() > 1 && shared.idle.load(std::memory_order_relaxed) != 0) {
+                    std::scoped_lock lock(shared.mutex);
+                    auto half = static_cast<std::ptrdiff_t>(local.size() / 2);
+                    std::move(local.begin(), local.begin() + half, std::back_inserter(shared.pending));
+                    local.erase(local.begin(), local.begin() + half);
+                    shared.wakeup.notify_all();
+                }
+
+                if (local.empty()) {
+                    std::scoped_lock lock(shared.mutex);
+                    if (--shared.busy == 0 && shared.pending.empty()) shared.wakeup.notify_all();
+                }
+            }
+        }
+
+        static void Read(Pending& item, std::vector<char>& buffer, std::vector<Pending>& local, const Visitor& visit, DirectoryUsage& usage)
+        {
+            std::shared_ptr<FileDescriptor> self;
+
+            try {
+                int base = item.parent ? item.parent->get() : AT_FDCWD;
+                int flags = item.parent ? O_RDONLY | O_DIRECTORY | O_NOFOLLOW : O_RDONLY | O_DIRECTORY;
+                self = std::make_shared<FileDescriptor>(base, item.name.c_str(), flags);
+            }
+            catch (const std::ios_base::failure&) {
+                ++usage.errors;
+                return;
+            }
+
+            item.parent.reset();
+
+            while (true) {
+                auto n = ::syscall(SYS_getdents64, self->get(), buffer.data(), buffer.size());
+                if (n == 0) return;
+
+                if (n < 0) {
+                    ++usage.errors;
+                    return;
+                }
+
+                for (long offset = 0; offset < n;) {
+                    const auto* entry = reinterpret_cast<const LinuxDirent64*>(buffer.data() + offset);
+                    offset += entry->d_reclen;
+                    std::string_view name(entry->d_name);
+                    if (name == "." || name == "..") continue;
+                    Inspect(self, name, entry->d_type, item.depth + 1, local, visit, usage);
+                }
+            }
+        }
+
+        /// Directories found through d_type need no statx() unless a visitor wants their metadata.
+        static void Inspect(const std::shared_ptr<FileDescriptor>& parent, std::string_view name, unsigned char d_type, std::size_t depth,
+                            std::vector<Pending>& local, const Visitor& visit, DirectoryUsage& usage)
+        {
+            DirectoryEntry entry{parent->get(), name, depth, ToFileType(d_type), 0, 0, {}};
+
+            if (d_type != DT_DIR || visit) {
+                struct statx status{};
+                auto mask = STATX_TYPE | STATX_SIZE | STATX_BLOCKS | STATX_MTIME;
+
+                if (::statx(parent->get(), name.data(), AT_SYMLINK_NOFOLLOW | AT_NO_AUTOMOUNT, mask, &status) != 0) {
+                    ++usage.errors;
+                    return;
+                }
+
+                entry.type = ToFileType(static_cast<unsigned char>(IFTODT(status.stx_mode)));
+                entry.size = status.stx_size;
+                entry.allocated = status.stx_blocks * 512;
+                auto since = std::chrono::seconds(status.stx_mtime.tv_sec) + std::chrono::nanoseconds(status.stx_mtime.tv_nsec);
+                entry.modified = std::chrono::system_clock::time_point(std::chrono::duration_cast<std::chrono::system_clock::duration>(since));
+            }
+
+            if (entry.type == std::filesystem::file_type::regular) {
+                ++usage.files;
+                usage.bytes += entry.size;
+                usage.allocated += entry.allocated;
+            }
+            else if (entry.type == std::filesystem::file_type::directory) {
+                ++usage.directories;
+                local.push_back(Pending{parent, std::string(name), depth});
+            }
+            else {
+                ++usage.others;
+            }
+
+            if (visit) visit(entry);
+        }
+
+        static std::filesystem::file_type ToFileType(unsigned char d_type) noexcept
+        {
+            using std::filesystem::file_type;
+
+            switch (d_type) {
+                case DT_REG: return file_type::regular;
+                case DT_DIR: return file_type::directory;
+                case DT_LNK: return file_type::symlink;
+                case DT_BLK: return file_type::block;
+                case DT_CHR: return file_type::character;
+                case DT_FIFO: return file_type::fifo;
+                case DT_SOCK: return file_type::socket;
+                default: return file_type::unknown;
+            }
+        }
+
+        std::size_t workers;
+    };
+
+}
+
+#endif //LIBS_DIRECTORY_HPP
@@ -0,0 +1,464 @@
+#ifndef LIBS_FOLLOW_HPP
+#define LIBS_FOLLOW_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <optional>
+#include <filesystem>
+#include <functional>
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <array>
+#include <unordered_map>
+#include <exception>
+#include <sstream>
+#include <iomanip>
+#include <cstdint>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#include <sys/inotify.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "./helper_objects.hpp"
+
+
+namespace hlibs::io {
+
+    /// An inotify descriptor with reference-counted watches: inotify returns the same watch descriptor for a path (or an
+    /// inode, e.g. the folder of two files) watched twice, so it is removed only when its last user releases it.
+    /// Not synchronized; its owner guards it.
+    class Watches final {
+      public:
+        Watches(): inotify(::inotify_init1(IN_NONBLOCK | IN_CLOEXEC))
+        {
+        }
+
+        Watches(const Watches& rhs) = delete;
+        Watches& operator=(const Watches& rhs) = delete;
+
+        Watches(Watches&& rhs) noexcept = delete;
+        Watches& operator=(Watches&& rhs) noexcept = delete;
+
+        ~Watches() noexcept = default;
+
+        /// The watch descriptor, or -1 (with errno set) on failure.
+        int add(const std::filesystem::path& p, std::uint32_t mask)
+        {
+            int wd = ::inotify_add_watch(inotify.get(), p.c_str(), mask);
+            if (wd != -1) ++counts[wd];
+            return wd;
+        }
+
+        void remove(int wd) noexcept
+        {
+            auto it = counts.find(wd);
+            if (it == counts.end() || --it->second != 0) return;
+            ::inotify_rm_watch(inotify.get(), wd);
+            counts.erase(it);
+        }
+
+        inline int get() const noexcept
+        {
+            return inotify.get();
+        }
+
+      private:
+        FileDescriptor inotify;
+        std::unordered_map<int, std::size_t> counts{};
+    };
+
+
+    /// The state of one followed file (tail -f): the unread position, the incomplete last line, and the inotify watches
+    /// of the file and of its folder. Truncation restarts reading from the beginning (as tail -f, it is noticed only while
+    /// the file is shorter than what has been read already); when the file is moved or deleted
+    /// (rotation), its rest is read and the new file under the same path is opened as soon as it appears. An overflow of the
+    /// inotify queue (lost events) makes it read the file again and check for a missed rotation.
+    class FollowedFile final {
+      public:
+        FollowedFile(const std::filesystem::path& p, Watches& registry, bool from_start)
+                : path(std::filesystem::absolute(p)), watches(registry), filename(path.filename().string())
+        {
+            directory_watch = watches.add(path.parent_path(), IN_CREATE | IN_MOVED_TO);
+            if (directory_watch == -1) throw std::ios_base::failure("inotify_add_watch()", std::error_code(errno, std::generic_category()));
+
+            if (!reopen(from_start)) {
+                auto error = errno;
+                watches.remove(directory_watch);
+                throw std::ios_base::failure("!reopen(path)", std::error_code(error, std::generic_category()));
+            }
+        }
+
+        FollowedFile(const FollowedFile& rhs) = delete;
+        FollowedFile& operator=(const FollowedFile& rhs) = delete;
+
+        FollowedFile(FollowedFile&& rhs) noexcept = delete;
+        FollowedFile& operator=(FollowedFile&& rhs) noexcept = delete;
+
+        ~FollowedFile() noexcept
+        {
+            if (file_watch != -1) watches.remove(file_watch);
+            watches.remove(directory_watch);
+        }
+
+        /// Reads everything appended since the last call and emits every completed line (without the line feed).
+        template<typename Emit>
+        void drain(Emit&& emit)
+        {
+            if (!descriptor) return;
+
+            struct stat status{};
+
+            if (::fstat(descriptor->get(), &status) == 0 && status.st_size < position) {
+                ::lseek(descriptor->get(), 0, SEEK_SET);
+                position = 0;
+                partial.clear();
+            }
+
+            std::array<char, 1UL << 16> buffer{};
+
+            while (true) {
+                auto n = ::read(descriptor->get(), buffer.data(), buffer.size());
+                if (n < 0 && errno == EINTR) continue;
+                if (n <= 0) return;
+                position += n;
+
+                std::string_view chunk(buffer.data(), static_cast<std::size_t>(n));
+
+                for (auto end = chunk.find('\n'); end != std::string_view::npos; end = chunk.find('\n')) {
+                    if (partial.empty()) {
+                        emit(chunk.substr(0, end));
+                    }
+                    else {
+                        partial.append(chunk.substr(0, end));
+                        emit(std::string_view(partial));
+                        partial.clear();
+                    }
+
+                    chunk.remove_prefix(end + 1);
+                }
+
+                partial.append(chunk);
+            }
+        }
+
+        /// Reacts to an inotify event if it concerns this file.
+        template<typename Emit>
+        void handle(const inotify_event& event, Emit&& emit)
+        {
+            if (event.mask & IN_Q_OVERFLOW) {
+                drain(emit);
+                if (isCurrent()) return;
+                release();
+                if (reopen(true)) drain(emit);
+            }
+            else if (event.wd == file_watch && (event.mask & (IN_MOVE_SELF | IN_DELETE_SELF))) {
+                drain(emit);
+                release();
+                if (reopen(true)) drain(emit);
+            }
+            else if (event.wd == file_watch && (event.mask & IN_MODIFY)) {
+                drain(emit);
+            }
+            else if (event.wd == directory_watch && event.len != 0 && filename == event.name && !isCurrent()) {
+                drain(emit);
+                release();
+                if (reopen(true)) drain(emit);
+            }
+        }
+
+        inline const std::filesystem::path& where() const noexcept
+        {
+            return path;
+        }
+
+      private:
+        /// Opens and watches the file now under the path (at its end unless from_start); false (with errno set) when there
+        /// is none yet or it cannot be watched (e.g. the limit of watches is reached, or it has been renamed away again).
+        /// The folder stays watched, so the next file created under the path is tried again.
+        bool reopen(bool from_start)
+        {
+            try {
+                descriptor.emplace(path, O_RDONLY | O_NONBLOCK);
+            }
+            catch (const std::ios_base::failure&) {
+                return false;
+            }
+
+            file_watch = watches.add(path, IN_MODIFY | IN_MOVE_SELF | IN_DELETE_SELF);
+
+            if (file_watch == -1) {
+                auto error = errno;
+                descriptor.reset();
+                errno = error;
+                return false;
+            }
+
+            position = from_start ? 0 : ::lseek(descriptor->get(), 0, SEEK_END);
+            return true;
+        }
+
+        void release()
+        {
+            if (file_watch != -1) watches.remove(file_watch);
+            file_watch = -1;
+            descriptor.reset();
+            partial.clear();
+        }
+
+        /// Whether the path still names the opened file (the same inode).
+        bool isCurrent() const noexcept
+        {
+            struct stat opened{};
+            struct stat named{};
+            if (!descriptor || ::fstat(descriptor->get(), &opened) != 0) return false;
+            return ::stat(path.c_str(), &named) == 0 && opened.st_ino == named.st_ino && opened.st_dev == named.st_dev;
+        }
+
+        std::filesystem::path path;
+        Watches& watches;
+        std::string filename;
+        std::optional<FileDescriptor> descriptor{};
+        off_t position = 0;
+        std::string partial{};
+        int file_watch = -1;
+        int directory_watch = -1;
+    };
+
+
+    /// Follows a single growing file and blocks on inotify until complete lines arrive.
+    class FileFollower final {
+      public:
+        explicit FileFollower(const std::filesystem::path& p, bool from_start = false): file(p, watches, from_start)
+        {
+        }
+
+        FileFollower(const FileFollower& rhs) = delete;
+        FileFollower& operator=(const FileFollower& rhs) = delete;
+
+        FileFollower(FileFollower&& rhs) noexcept = delete;
+        FileFollower& operator=(FileFollower&& rhs) noexcept = delete;
+
+        ~FileFollower() noexcept = default;
+
+        /// The next line, or nothing if no complete line has arrived within the timeout.
+        std::optional<std::string> getNextLine(std::chrono::milliseconds timeout = std::chrono::milliseconds::max())
+        {
+            auto deadline = timeout == std::chrono::milliseconds::max() ? std::chrono::steady_clock::time_point::max()
+                                                                        : std::chrono::steady_clock::now() + timeout;
+            auto push = [this](std::string_view line) { ready.emplace_back(line); };
+
+            file.drain(push);
+
+            while (ready.empty()) {
+                int wait = -1;
+
+                if (deadline != std::chrono::steady_clock::time_point::max()) {
+                    auto left = std::chrono::ceil<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now());
+                    if (left.count() <= 0) return std::nullopt;
+                    wait = static_cast<int>(left.count());
+                }
+
+                pollfd waiting{watches.get(), POLLIN, 0};
+                if (::poll(&waiting, 1, wait) > 0) Dispatch(watches.get(), [this, &push](const inotify_event& e) { file.handle(e, push); });
+            }
+
+            auto line = std::move(ready.front());
+            ready.pop_front();
+            ++lines_read;
+            return line;
+        }
+
+        inline std::size_t lines() const noexcept
+        {
+            return lines_read;
+        }
+
+        /// {"$Path","$NumberOfLinesRead"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            std::stringstream ss;
+            ss << '{';
+            ss << std::quoted(file.where().string()) << ',';
+            ss << std::quoted(std::to_string(lines_read));
+            ss << '}';
+            return ss.str();
+        }
+
+        /// Reads all the pending inotify events and passes them on one by one.
+        template<typename Handler>
+        static void Dispatch(int inotify_fd, Handler&& handler)
+        {
+            alignas(inotify_event) std::array<char, 4096> events{};
+
+            while (true) {
+                auto n = ::read(inotify_fd, events.data(), events.size());
+                if (n <= 0) return;
+
+                for (ssize_t offset = 0; offset < n;) {
+                    const auto* event = reinterpret_cast<const inotify_event*>(events.data() + offset);
+                    handler(*event);
+                    offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                }
+            }
+        }
+
+      private:
+        Watches watches{};
+        FollowedFile file;
+        std::deque<std::string> ready{};
+        std::size_t lines_read = 0;
+    };
+
+
+    /// Follows many files on one background thread (epoll over a single inotify descriptor).
+    /// The callback is called on that thread for every new line, file by file in the order of appearance, without any
+    /// lock held (so it may call follow()); if it throws, the first exception is kept for error() and following goes on.
+    class FollowGroup final {
+      public:
+        using Callback = std::function<void(const std::filesystem::path&, std::string_view)>;
+
+        explicit FollowGroup(Callback on_line)
+                : callback(std::move(on_line)), wakeup(::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC)), epoll(::epoll_create1(EPOLL_CLOEXEC))
+        {
+            epoll_event interest{};
+            interest.events = EPOLLIN;
+            interest.data.fd = watches.get();
+            ::epoll_ctl(epoll.get(), EPOLL_CTL_ADD, watches.get(), &interest);
+            interest.data.fd = wakeup.get();
+            ::epoll_ctl(epoll.get(), EPOLL_CTL_ADD, wakeup.get(), &interest);
+            worker = std::jthread([this] { run(); });
+        }
+
+        FollowGroup(const FollowGroup& rhs) = delete;
+        FollowGroup& operator=(const FollowGroup& rhs) = delete;
+
+        FollowGroup(FollowGroup&& rhs) noexcept = delete;
+        FollowGroup& operator=(FollowGroup&& rhs) noexcept = delete;
+
+        ~FollowGroup() noexcept
+        {
+            stopping = true;
+            notify();
+            if (worker.joinable()) worker.join();
+        }
+
+        void follow(const std::filesystem::path& p, bool from_start = false)
+        {
+            {
+                std::scoped_lock lock(mutex);
+                files.push_back(std::make_unique<FollowedFile>(p, watches, from_start));
+            }
+
+            notify();
+        }
+
+        inline std::size_t lines() const noexcept
+        {
+            return lines_read.load(std::memory_order_relaxed);
+        }
+
+        /// The first exception thrown by the callback (null if none).
+        std::exception_ptr error() const
+        {
+            std::scoped_lock lock(mutex);
+            return failure;
+        }
+
+        /// {"$NumberOfFiles","$NumberOfLinesRead"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            std::size_t count = 0;
+
+            {
+                std::scoped_lock lock(mutex);
+                count = files.size();
+            }
+
+            std::stringstream ss;
+            ss << '{';
+            ss << std::quoted(std::to_string(count)) << ',';
+            ss << std::quoted(std::to_string(lines()));
+            ss << '}';
+            return ss.str();
+        }
+
+      private:
+        void notify() noexcept
+        {
+            std::uint64_t one = 1;
+            [[maybe_unused]] auto n = ::write(wakeup.get(), &one, sizeof(one));
+        }
+
+        /// Lines of one round, kept to be passed to the callback once the lock is released (the paths stay valid, as
+        /// files are never removed).
+        using Batch = std::vector<std::pair<const std::filesystem::path*, std::string>>;
+
+        static auto Collector(Batch& batch, const FollowedFile& file)
+        {
+            return [&batch, &file](std::string_view line) { batch.emplace_back(&file.where(), line); };
+        }
+
+        void run()
+        {
+            std::array<epoll_event, 2> ready{};
+            Batch batch;
+
+            while (!stopping) {
+                int count = ::epoll_wait(epoll.get(), ready.data(), static_cast<int>(ready.size()), -1);
+
+                {
+                    std::scoped_lock lock(mutex);
+
+                    for (int i = 0; i < count; ++i) {
+                        if (ready[static_cast<std::size_t>(i)].data.fd == wakeup.get()) {
+                            std::uint64_t value = 0;
+                            [[maybe_unused]] auto n = ::read(wakeup.get(), &value, sizeof(value));
+                            for (auto& file : files) file->drain(Collector(batch, *file));
+                            continue;
+                        }
+
+                        FileFollower::Dispatch(watches.get(), [this, &batch](const inotify_event& event) {
+                            for (auto& file : files) file->handle(event, Collector(batch, *file));
+                        });
+                    }
+                }
+
+                for (const auto& [path, line] : batch) {
+                    lines_read.fetch_add(1, std::memory_order_relaxed);
+
+                    try {
+                        callback(*path, line);
+                    }
+                    catch (...) {
+                        std::scoped_lock lock(mutex);
+                        if (!failure) failure = std::current_exception();
+                    }
+                }
+
+                batch.clear();
+            }
+        }
+
+        Callback callback;
+        Watches watches{};
+        FileDescriptor wakeup;
+        FileDescriptor epoll;
+        mutable std::mutex mutex;
+        std::vector<std::unique_ptr<FollowedFile>> files{};
+        std::exception_ptr failure{};
+        std::atomic<std::size_t> lines_read = 0;
+        std::atomic<bool> stopping = false;
+        std::jthread worker;    ///< declared last to be joined before the rest is destroyed
+    };
+
+}
+
+#endif //LIBS_FOLLOW_HPP
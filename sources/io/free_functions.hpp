@@ -4,6 +4,16 @@
 #include <fstream>
 #include <sys/stat.h>
 #include <filesystem>
+#include <array>
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/sendfile.h>
+#include <functional>
+#include <limits>
+#include <stdexcept>
 
 
 namespace hlibs::io {
@@ -22,6 +32,142 @@ namespace hlibs::io {
         return rc == 0 ? stat_buffer.st_size : -1;
     }
 
+    /// Reports the bytes copied so far out of those requested.
+    using TransferProgress = std::function<void(std::size_t copied, std::size_t count)>;
+
+    /// Copies up to count bytes between descriptors inside the kernel (copy_file_range, or sendfile, which writes at the
+    /// file position of the target, so it is moved to the given offset and back), or through a bounded buffer where the
+    /// kernel cannot do it. Given offsets are used and advanced instead of the file positions. The progress is reported
+    /// after every step (of at most step bytes).
+    [[maybe_unused]] static std::size_t CopyBytes(int in, off_t* in_offset, int out, off_t* out_offset, std::size_t count,
+                                                  const TransferProgress& progress = {}, std::size_t step = 1UL << 23)
+    {
+        std::size_t copied = 0;
+        std::size_t reported = 0;
+        step = std::max<std::size_t>(step, 1);
+
+        const auto advance = [&](std::size_t n) {
+            copied += n;
+
+            if (progress && (copied - reported >= step || copied == count)) {
+                reported = copied;
+                progress(copied, count);
+            }
+        };
+
+        const auto isUnsupported = [](int error) {
+            return error == EXDEV || error == EINVAL || error == ENOSYS || error == EOPNOTSUPP;
+        };
+
+        // copy_file_range() fails with EBADF on a target opened with O_APPEND, which sendfile() and write() handle
+        const auto flags = ::fcntl(out, F_GETFL);
+        if (flags == -1) throw std::ios_base::failure("fcntl(out)", std::error_code(errno, std::generic_category()));
+
+        while (copied != count && (flags & O_APPEND) == 0) {
+            auto n = ::copy_file_range(in, in_offset, out, out_offset, std::min(step, count - copied), 0);
+
+            if (n > 0) {
+                advance(static_cast<std::size_t>(n));
+                continue;
+            }
+
+            if (n == 0 || isUnsupported(errno)) break;
+            if (errno != EINTR) throw std::ios_base::failure("copy_file_range()", std::error_code(errno, std::generic_category()));
+        }
+
+        const auto position = out_offset ? ::lseek(out, 0, SEEK_CUR) : 0;
+        const bool seekable = out_offset == nullptr || (position != -1 && ::lseek(out, *out_offset, SEEK_SET) != -1);
+
+        while (copied != count && seekable) {
+            auto n = ::sendfile(out, in, in_offset, std::min(step, count - copied));
+
+            if (n > 0) {
+                if (out_offset) *out_offset += n;
+                advance(static_cast<std::size_t>(n));
+                continue;
+            }
+
+            if (n == 0 || isUnsupported(errno)) break;
+            if (errno == EINTR) continue;
+
+            auto error = errno;
+            if (out_offset) ::lseek(out, position, SEEK_SET);
+            throw std::ios_base::failure("sendfile()", std::error_code(error, std::generic_category()));
+        }
+
+        if (out_offset && seekable) ::lseek(out, position, SEEK_SET);
+
+        std::array<char, 1UL << 16> buffer{};
+
+        while (copied != count) {
+            auto wanted = std::min(buffer.size(), count - copied);
+            auto n = in_offset ? ::pread(in, buffer.data(), wanted, *in_offset) : ::read(in, buffer.data(), wanted);
+
+            if (n == 0) break;
+
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::ios_base::failure("read()", std::error_code(errno, std::generic_category()));
+            }
+
+            if (in_offset) *in_offset += n;
+
+            for (ssize_t done = 0; done != n;) {
+                auto chunk = static_cast<std::size_t>(n - done);
+                auto w = out_offset ? ::pwrite(out, buffer.data() + done, chunk, *out_offset) : ::write(out, buffer.data() + done, chunk);
+
+                if (w < 0) {
+                    if (errno == EINTR) continue;
+                    throw std::ios_base::failure("write()", std::error_code(errno, std::generic_category()));
+                }
+
+                if (out_offset) *out_offset += w;
+                done += w;
+            }
+
+            advance(static_cast<std::size_t>(n));
+        }
+
+        if (progress && reported != copied) progress(copied, count);
+        return copied;
+    }
+
+    /// Copies length bytes (or up to the end) from the offset of the source to the offset of the target, with constant
+    /// memory use. The target is created when missing and is neither truncated nor moved; returns the bytes copied.
+    [[maybe_unused]] static std::size_t TransferFile(const std::filesystem::path& source, const std::filesystem::path& target, off_t source_offset = 0,
+                                                     off_t target_offset = 0, std::size_t length = std::numeric_limits<std::size_t>::max(),
+                                                     const TransferProgress& progress = {})
+    {
+        auto size = GetFileSize(source);
+        if (size < 0) throw std::ios_base::failure("GetFileSize(source) < 0");
+        if (source_offset < 0 || target_offset < 0) throw std::invalid_argument("offset < 0");
+
+        auto available = source_offset < size ? static_cast<std::size_t>(size - source_offset) : 0;
+        auto count = std::min(length, available);
+
+        int in = ::open(source.c_str(), O_RDONLY | O_CLOEXEC);
+        if (in == -1) throw std::ios_base::failure("open(source)", std::error_code(errno, std::generic_category()));
+        int out = ::open(target.c_str(), O_WRONLY | O_CREAT | O_CLOEXEC, 0644);
+
+        if (out == -1) {
+            auto error = errno;
+            ::close(in);
+            throw std::ios_base::failure("open(target)", std::error_code(error, std::generic_category()));
+        }
+
+        try {
+            auto copied = CopyBytes(in, &source_offset, out, &target_offset, count, progress);
+            ::close(in);
+            ::close(out);
+            return copied;
+        }
+        catch (...) {
+            ::close(in);
+            ::close(out);
+            throw;
+        }
+    }
+
 }
 
 #endif //LIBS_FREE_FUNCTIONS_HPP
@@ -15,32 +15,138 @@
 #include <unordered_map>
 #include <limits>
 #include <array>
+#include <iostream>
+#include <chrono>
+#include <cstring>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <exception>
+#include <stop_token>
+#include <utility>
+#include <charconv>
+#include <span>
+#include <cmath>
+#include <algorithm>
+#include <type_traits>
+
+#include <sys/uio.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <climits>
+#include <cerrno>
+#include <system_error>
+#include <initializer_list>
+#include <optional>
+#include <list>
+#include <sys/stat.h>
 
 #include "./free_functions.hpp"
+#include "../standard/compression.hpp"
+#include "../facilities/hashing.hpp"
+#include "../facilities/strings.hpp"
+#include "../facilities/formatting.hpp"
 
 
 namespace hlibs::io {
 
-    /// Redirects std::cout, std::cerr, or std::clog to a file.
-    class StreamToFile final : private std::filebuf {
+    /// Owns a POSIX file descriptor (closed on destruction).
+    class FileDescriptor final {
+      public:
+        /// url:https://man7.org/linux/man-pages/man2/open.2.html
+        explicit FileDescriptor(const std::filesystem::path& p, int flags = O_RDONLY, mode_t mode = 0644): fd(::open(p.c_str(), flags | O_CLOEXEC, mode))
+        {
+            if (fd == -1) throw std::ios_base::failure("open() == -1", std::error_code(errno, std::generic_category()));
+        }
+
+        /// Takes over a descriptor returned by a system call (such as inotify_init1() or eventfd()).
+        explicit FileDescriptor(int descriptor): fd(descriptor)
+        {
+            if (fd == -1) throw std::ios_base::failure("descriptor == -1", std::error_code(errno, std::generic_category()));
+        }
+
+        /// Opens the name relative to an open directory (or AT_FDCWD).
+        FileDescriptor(int directory, const char* name, int flags = O_RDONLY): fd(::openat(directory, name, flags | O_CLOEXEC))
+        {
+            if (fd == -1) throw std::ios_base::failure("openat() == -1", std::error_code(errno, std::generic_category()));
+        }
+
+        FileDescriptor(const FileDescriptor& rhs) = delete;
+        FileDescriptor& operator=(const FileDescriptor& rhs) = delete;
+
+        FileDescriptor(FileDescriptor&& rhs) noexcept: fd(std::exchange(rhs.fd, -1))
+        {
+        }
+
+        FileDescriptor& operator=(FileDescriptor&& rhs) noexcept
+        {
+            if (this == &rhs) return *this;
+            if (fd != -1) ::close(fd);
+            fd = std::exchange(rhs.fd, -1);
+            return *this;
+        }
+
+        ~FileDescriptor() noexcept
+        {
+            if (fd != -1) ::close(fd);
+        }
+
+        inline int get() const noexcept
+        {
+            return fd;
+        }
+
+      private:
+        int fd;
+    };
+
+
+    /// Redirects std::cout, std::cerr, or std::clog to a file (through a buffer of the given capacity), or captures it in memory.
+    /// With a non-zero interval, the output is written out by a background thread: the stream fills one buffer while the
+    /// thread writes the other, and the filled buffer is handed over when it is full or on a flush. When nothing has been
+    /// handed over for an interval, the thread writes out what the stream has appended so far by itself, so output printed
+    /// before a pause reaches the file. Appending publishes the fill level with an atomic store; only a handover takes the
+    /// lock and it waits only if the other buffer is still pending.
+    class StreamToFile final : private std::streambuf {
       public:
-        StreamToFile(std::ostream& stream, const std::string& path): ref_stream(stream), ptr_buffer(stream.rdbuf())
+        StreamToFile(std::ostream& stream, const std::string& path, std::size_t capacity = 1UL << 16, std::chrono::milliseconds interval = {})
+                : ref_stream(stream), ptr_buffer(stream.rdbuf()), target(std::in_place, path, O_WRONLY | O_CREAT | O_TRUNC),
+                  front(std::max<std::size_t>(capacity, 1)), background(interval.count() > 0)
         {
-            open(path.c_str(), std::ios_base::out);
-            if (!is_open()) throw std::ios_base::failure("!is_open()");
+            setp(front.data(), front.data() + front.size());
+
+            if (background) {
+                setp(nullptr, nullptr);     // every insertion goes through xsputn(), which publishes the fill level
+                back.resize(front.size());
+                worker = std::jthread([this, interval](std::stop_token token) { writeBehind(token, interval); });
+            }
+
             stream.rdbuf(this);
         }
 
-        /// This destructor is needed to not cause SIGSEGV for the underlying buffer.
-        ~StreamToFile() noexcept override try
+        /// Captures the output in a growable arena of chunks (starting at the given size) instead of writing it anywhere.
+        static StreamToFile Capture(std::ostream& stream, std::size_t chunk = 1UL << 12)
         {
-            auto buffer = std::any_cast<decltype(ref_stream.get().rdbuf())>(ptr_buffer);
-            ref_stream.get().rdbuf(buffer);
-            ptr_buffer.reset();
-            close();
+            return StreamToFile(stream, std::max<std::size_t>(chunk, 1));
         }
-        catch (const std::bad_any_cast& e) {
-            std::cerr << "~StreamToFile->bad_any_cast: " << e.what();
+
+        /// This destructor is needed to not cause SIGSEGV for the underlying buffer; the worker writes out the last handover
+        /// before it is joined.
+        ~StreamToFile() noexcept override
+        {
+            try {
+                auto buffer = std::any_cast<decltype(ref_stream.get().rdbuf())>(ptr_buffer);
+                ref_stream.get().rdbuf(buffer);
+                ptr_buffer.reset();
+                if (target) sync();
+            }
+            catch (const std::bad_any_cast& e) {
+                std::cerr << "~StreamToFile->bad_any_cast: " << e.what();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "~StreamToFile->exception: " << e.what();
+            }
         }
 
         StreamToFile(const StreamToFile& rhs) = delete;
@@ -50,20 +156,236 @@ namespace hlibs::io {
         StreamToFile(StreamToFile&& rhs) noexcept = delete;
         StreamToFile& operator=(StreamToFile&& rhs) noexcept = delete;
 
+        /// Everything captured so far (empty when redirecting to a file).
+        [[nodiscard]] std::string captured() const
+        {
+            std::string text;
+            if (target) return text;
+
+            for (std::size_t i = 0; i + 1 < arena.size(); ++i) text.append(arena[i].data(), arena[i].size());
+            text.append(pbase(), static_cast<std::size_t>(pptr() - pbase()));
+            return text;
+        }
+
+        /// Drops the captured output while keeping the largest chunk for reuse.
+        void clear()
+        {
+            if (target) return;
+
+            auto largest = std::move(arena.back());
+            arena.clear();
+            largest.resize(largest.capacity());
+            arena.push_back(std::move(largest));
+            setp(arena.back().data(), arena.back().data() + arena.back().size());
+        }
+
         /// {"StreamAddress","CompilerSpecificStreamDeclaredTypeName"}
         [[nodiscard]] std::string toString() const noexcept
         {
-            std::ostringstream ss;
-            ss << '{';
-            ss << '"' << &ref_stream << "\",";
-            ss << std::quoted(typeid(decltype(ref_stream)).name());
-            ss << '}';
-            return ss.str();
+            facilities::formatting::StringBuilder<> builder;
+            builder << "{\"" << &ref_stream << "\",";
+            builder.appendQuoted(typeid(decltype(ref_stream)).name());
+            builder << '}';
+            return builder.str();
+        }
+
+      protected:
+        int_type overflow(int_type ch) override
+        {
+            if (traits_type::eq_int_type(ch, traits_type::eof())) return sync() == 0 ? traits_type::not_eof(ch) : traits_type::eof();
+            char symbol = traits_type::to_char_type(ch);
+            return xsputn(&symbol, 1) == 1 ? ch : traits_type::eof();
+        }
+
+        std::streamsize xsputn(const char* s, std::streamsize n) override
+        {
+            auto count = static_cast<std::size_t>(n);
+
+            if (!target) {
+                grow(count);
+                std::memcpy(pptr(), s, count);
+                pbump(static_cast<int>(count));
+                return n;
+            }
+
+            if (background) {
+                append({s, count});
+                return n;
+            }
+
+            auto space = static_cast<std::size_t>(epptr() - pptr());
+
+            if (count <= space) {
+                std::memcpy(pptr(), s, count);
+                pbump(static_cast<int>(count));
+                return n;
+            }
+
+            sync();
+
+            if (count >= front.size()) {
+                WriteOut(target->get(), {s, count});
+                return n;
+            }
+
+            std::memcpy(pptr(), s, count);
+            pbump(static_cast<int>(count));
+            return n;
+        }
+
+        int sync() override
+        {
+            if (!target) return 0;
+
+            if (background) {
+                handOver();
+                return 0;
+            }
+
+            WriteOut(target->get(), {pbase(), static_cast<std::size_t>(pptr() - pbase())});
+            setp(front.data(), front.data() + front.size());
+            return 0;
         }
 
       private:
+        /// The capture mode.
+        StreamToFile(std::ostream& stream, std::size_t chunk): ref_stream(stream), ptr_buffer(stream.rdbuf())
+        {
+            arena.emplace_back(chunk);
+            setp(arena.back().data(), arena.back().data() + arena.back().size());
+            stream.rdbuf(this);
+        }
+
+        /// Seals the current chunk and starts a twice larger one (or one large enough) when n bytes do not fit.
+        void grow(std::size_t n)
+        {
+            if (static_cast<std::size_t>(epptr() - pptr()) >= n) return;
+
+            auto used = static_cast<std::size_t>(pptr() - pbase());
+            auto size = std::max(arena.back().size() * 2, n);
+            arena.back().resize(used);
+            arena.emplace_back(size);
+            setp(arena.back().data(), arena.back().data() + arena.back().size());
+        }
+
+        /// Copies the bytes behind those of the front buffer (handing it over first when they do not fit) and publishes
+        /// the new fill level to the worker; bytes that fill the whole buffer are written out directly, in order.
+        void append(std::span<const char> data)
+        {
+            auto at = filled.load(std::memory_order_relaxed);
+
+            if (data.size() > front.size() - at) {
+                handOver();
+                at = 0;
+            }
+
+            if (data.size() >= front.size()) {
+                awaitWritten();
+                WriteOut(target->get(), data);
+                return;
+            }
+
+            std::memcpy(front.data() + at, data.data(), data.size());
+            filled.store(at + data.size(), std::memory_order_release);
+        }
+
+        /// Swaps the filled buffer for the written one and lets the worker write out the bytes it has not taken yet; waits
+        /// only while the other buffer (or a part of the front one taken by the worker) is still pending.
+        void handOver()
+        {
+            bool isHandedOver = false;
+
+            {
+                std::unique_lock lock(mutex);
+                awaitWritten(lock);
+                auto end = filled.load(std::memory_order_relaxed);
+
+                if (end != taken) {
+                    std::swap(front, back);
+                    pending = {back.data() + taken, end - taken};
+                    isHandedOver = true;
+                }
+
+                filled.store(0, std::memory_order_relaxed);
+                taken = 0;
+            }
+
+            if (isHandedOver) wakeup.notify_one();
+        }
+
+        void awaitWritten()
+        {
+            std::unique_lock lock(mutex);
+            awaitWritten(lock);
+        }
+
+        /// Rethrows the failure of the worker, after which nothing more is written.
+        void awaitWritten(std::unique_lock<std::mutex>& lock)
+        {
+            written.wait(lock, [this] { return pending.empty() || failure; });
+            if (failure) std::rethrow_exception(failure);
+        }
+
+        /// Writes out every handover (the last one even when stopped) and, after an interval without one, the bytes appended
+        /// to the front buffer so far; the stream keeps appending behind them meanwhile.
+        void writeBehind(std::stop_token token, std::chrono::milliseconds interval)
+        {
+            std::unique_lock lock(mutex);
+
+            while (true) {
+                if (!wakeup.wait_for(lock, token, interval, [this] { return !pending.empty(); })) {
+                    if (token.stop_requested()) return;
+
+                    auto end = filled.load(std::memory_order_acquire);
+                    if (end == taken) continue;
+                    pending = {front.data() + taken, end - taken};
+                    taken = end;
+                }
+
+                auto data = pending;
+                lock.unlock();
+
+                try {
+                    WriteOut(target->get(), data);
+                }
+                catch (...) {
+                    lock.lock();
+                    failure = std::current_exception();
+                    written.notify_all();
+                    return;
+                }
+
+                lock.lock();
+                pending = {};
+                written.notify_all();
+            }
+        }
+
+        static void WriteOut(int fd, std::span<const char> data)
+        {
+            while (!data.empty()) {
+                auto n = ::write(fd, data.data(), data.size());
+                if (n < 0 && errno == EINTR) continue;
+                if (n < 0) throw std::ios_base::failure("write()", std::error_code(errno, std::generic_category()));
+                data = data.subspan(static_cast<std::size_t>(n));
+            }
+        }
+
         std::reference_wrapper<std::ostream> ref_stream;
         std::any ptr_buffer;
+        std::optional<FileDescriptor> target{};
+        std::vector<char> front{};
+        std::vector<char> back{};
+        bool background = false;
+        std::vector<std::vector<char>> arena{};
+        std::atomic<std::size_t> filled{0};     ///< bytes appended to front in the background mode
+        std::size_t taken = 0;                  ///< bytes of front already given to the worker
+        std::span<const char> pending{};        ///< bytes handed over to the worker and not yet written
+        std::exception_ptr failure{};
+        std::mutex mutex;
+        std::condition_variable_any wakeup;
+        std::condition_variable_any written;
+        std::jthread worker;    ///< declared last to be joined before the rest is destroyed
     };
 
 
@@ -87,13 +409,44 @@ namespace hlibs::io {
 
         ~FileLoader() noexcept = default;
 
+        /// Compressed frames (see standard::compression::Frame) are decompressed transparently.
         void read()
         {
+            if (standard::compression::Frame::IsFramed(file)) {
+                standard::compression::DecompressingBuffer decoder(file.rdbuf());
+                content = std::vector<char>(std::istreambuf_iterator<char>(&decoder), std::istreambuf_iterator<char>());
+                return;
+            }
+
             auto first = (std::istreambuf_iterator<char>(file));
             auto last = (std::istreambuf_iterator<char>());
             content = std::vector<char>(first, last);
         }
 
+        /// Feeds the checksum chunk by chunk while loading (after decompression), so verifying takes no second pass.
+        template<facilities::hashing::Checksum T>
+        void read(T& checksum)
+        {
+            constexpr std::size_t chunk = 1UL << 16;
+            std::optional<standard::compression::DecompressingBuffer> decoder{};
+            std::streambuf* source = file.rdbuf();
+
+            if (standard::compression::Frame::IsFramed(file)) {
+                decoder.emplace(file.rdbuf());
+                source = &*decoder;
+            }
+
+            content.clear();
+
+            for (std::streamsize n = 1; n > 0;) {
+                auto size = content.size();
+                content.resize(size + chunk);
+                n = std::max<std::streamsize>(source->sgetn(content.data() + size, chunk), 0);
+                content.resize(size + static_cast<std::size_t>(n));
+                checksum.update(std::string_view(content.data() + size, static_cast<std::size_t>(n)));
+            }
+        }
+
         inline const std::vector<char>& data() const noexcept
         {
             return content;
@@ -102,11 +455,9 @@ namespace hlibs::io {
         /// {"$Path","$FileAddress","$DataSize"}
         [[nodiscard]] std::string toString() const noexcept
         {
-            std::stringstream ss{"{"};
-            ss << '"' + path.string() + "\",\"";
-            ss << &file;
-            ss << "\",\"" << std::to_string(content.size()) + "\"}";
-            return ss.str();
+            facilities::formatting::StringBuilder<> builder;
+            builder << "{\"" << path.native() << "\",\"" << &file << "\",\"" << content.size() << "\"}";
+            return builder.str();
         }
 
       private:
@@ -122,6 +473,7 @@ namespace hlibs::io {
 
 
     // Allows to read a text file line-by-line (and counts the number of lines already read).
+    // Compressed frames (see standard::compression::Frame) are decompressed transparently.
     class FileReader final {
       public:
         explicit FileReader(const std::filesystem::path& p): path(p), file(std::ifstream(p, std::ios::in))
@@ -130,6 +482,12 @@ namespace hlibs::io {
                 file.close();
                 throw std::ios::failure("file.fail() || !file.is_open()");
             }
+
+            if (standard::compression::Frame::IsFramed(file)) {
+                decoder = std::make_unique<standard::compression::DecompressingBuffer>(file.rdbuf());
+                static_cast<std::istream&>(file).rdbuf(decoder.get());
+                file.exceptions(std::ios::badbit);    // a corrupted frame throws instead of reading as a shorter file
+            }
         }
 
         FileReader(const FileReader& rhs) = delete;
@@ -149,7 +507,7 @@ namespace hlibs::io {
             return line;
         }
 
-        inline bool hasNextLine() noexcept
+        inline bool hasNextLine()
         {
             return !hlibs::io::IsEOF(file);
         }
@@ -157,12 +515,9 @@ namespace hlibs::io {
         /// {"$Path","$FileAddress","$NumberOfLinesRead"}
         [[nodiscard]] std::string toString() const noexcept
         {
-            std::stringstream ss{"{"};
-            ss << '"' << path << "\",";
-            ss << '"' << &file << "\",";
-            ss << '"' << std::to_string(lines_read) << '"';
-            ss << '}';
-            return ss.str();
+            facilities::formatting::StringBuilder<> builder;
+            builder << "{\"" << path.native() << "\",\"" << &file << "\",\"" << lines_read << "\"}";
+            return builder.str();
         }
 
         inline std::size_t lines() const noexcept
@@ -170,13 +525,203 @@ namespace hlibs::io {
             return lines_read;
         }
 
+        /// Reads the remaining lines and calls on_match(line_number, line, match) for every occurrence of the keywords;
+        /// returns the number of lines with at least one.
+        template<typename F>
+        std::size_t scan(const facilities::strings::Keywords& keywords, F&& on_match)
+        {
+            std::size_t matching = 0;
+            std::string line;
+
+            while (std::getline(file, line)) {
+                ++lines_read;
+                bool isMatching = false;
+
+                keywords.findAll(line, [&](const facilities::strings::Match& match) {
+                    isMatching = true;
+                    on_match(lines_read, std::string_view(line), match);
+                });
+
+                matching += isMatching;
+            }
+
+            return matching;
+        }
+
+        /// Feeds the checksum with the (decompressed) bytes read from now on. It reads ahead by chunks, so the
+        /// checksum matches the bytes returned once the file has been read to the end. Only one checksum per reader.
+        template<facilities::hashing::Checksum T>
+        void checksum(T& sum)
+        {
+            if (checksummer) throw std::logic_error("checksum() twice");
+            auto& stream = static_cast<std::istream&>(file);
+            checksummer = std::make_unique<facilities::hashing::ChecksumBuffer<T>>(stream.rdbuf(), sum);
+            stream.rdbuf(checksummer.get());
+        }
+
       private:
         std::filesystem::path path;
         std::ifstream file;
+        std::unique_ptr<standard::compression::DecompressingBuffer> decoder{};
+        std::unique_ptr<std::streambuf> checksummer{};
         std::size_t lines_read = 0;
     };
 
 
+    /// Counters of a block cache (each one read on its own, so they may be slightly out of step with each other).
+    struct BlockCacheStats {
+        std::size_t hits = 0;
+        std::size_t misses = 0;
+        std::size_t evictions = 0;
+    };
+
+
+    /// Reads bytes at arbitrary offsets with pread(), served from an LRU cache of fixed-size blocks that holds at most
+    /// the memory budget. The cache is split into shards (each with its own lock), so many threads may read at once.
+    /// The file is expected not to change while it is open; its size is taken on construction.
+    class PositionalReader final {
+      public:
+        explicit PositionalReader(const std::filesystem::path& p, std::size_t block_size = 1UL << 16, std::size_t budget = 1UL << 26,
+                                  std::size_t shards = 16)
+                : path(p), descriptor(p), block(std::max<std::size_t>(block_size, 1)), shard_count(std::max<std::size_t>(shards, 1)),
+                  shard_capacity(std::max<std::size_t>(budget / block / shard_count, 1)), table(std::make_unique<Shard[]>(shard_count))
+        {
+            struct stat info{};
+            if (::fstat(descriptor.get(), &info) == -1) throw std::ios_base::failure("fstat() == -1", std::error_code(errno, std::generic_category()));
+            length = static_cast<std::size_t>(info.st_size);
+        }
+
+        PositionalReader(const PositionalReader& rhs) = delete;
+        PositionalReader& operator=(const PositionalReader& rhs) = delete;
+
+        PositionalReader(PositionalReader&& rhs) noexcept = delete;
+        PositionalReader& operator=(PositionalReader&& rhs) noexcept = delete;
+
+        ~PositionalReader() noexcept = default;
+
+        /// Copies up to target.size() bytes from the offset; returns fewer only at the end of the file. Thread-safe.
+        std::size_t read(std::size_t offset, std::span<char> target)
+        {
+            if (offset >= length) return 0;
+            auto count = std::min(target.size(), length - offset);
+
+            for (std::size_t done = 0; done != count;) {
+                auto position = offset + done;
+                auto data = fetch(position / block);
+                auto from = position % block;
+                auto n = std::min(count - done, data->size() - from);
+                std::memcpy(target.data() + done, data->data() + from, n);
+                done += n;
+            }
+
+            return count;
+        }
+
+        std::string read(std::size_t offset, std::size_t count)
+        {
+            std::string text(offset >= length ? 0 : std::min(count, length - offset), '\0');
+            read(offset, std::span<char>(text.data(), text.size()));
+            return text;
+        }
+
+        inline std::size_t size() const noexcept
+        {
+            return length;
+        }
+
+        /// Blocks the cache holds at most (across all shards).
+        inline std::size_t capacity() const noexcept
+        {
+            return shard_capacity * shard_count;
+        }
+
+        BlockCacheStats stats() const noexcept
+        {
+            return {hits.load(std::memory_order_relaxed), misses.load(std::memory_order_relaxed), evictions.load(std::memory_order_relaxed)};
+        }
+
+        /// {"$Path","$FileSize","$Hits","$Misses","$Evictions"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            auto [hit, miss, evicted] = stats();
+            facilities::formatting::StringBuilder<> builder;
+            builder << '{';
+            builder.appendQuoted(path.native());
+            builder << ",\"" << length << "\",\"" << hit << "\",\"" << miss << "\",\"" << evicted << "\"}";
+            return builder.str();
+        }
+
+      private:
+        using Data = std::shared_ptr<const std::vector<char>>;    ///< shared, so a block evicted while being copied stays alive
+
+        struct Shard {
+            std::mutex mutex;
+            std::list<std::pair<std::size_t, Data>> order;        ///< most recently used first
+            std::unordered_map<std::size_t, std::list<std::pair<std::size_t, Data>>::iterator> where;
+        };
+
+        Data fetch(std::size_t index)
+        {
+            auto& shard = table[(index * 0x9E3779B97F4A7C15ULL >> 32) % shard_count];
+
+            {
+                std::lock_guard lock(shard.mutex);
+                if (auto it = shard.where.find(index); it != shard.where.end()) {
+                    shard.order.splice(shard.order.begin(), shard.order, it->second);
+                    hits.fetch_add(1, std::memory_order_relaxed);
+                    return it->second->second;
+                }
+            }
+
+            // The block is read outside the lock; if another thread loads it meanwhile, its copy is kept.
+            misses.fetch_add(1, std::memory_order_relaxed);
+            auto data = load(index);
+            std::lock_guard lock(shard.mutex);
+
+            if (auto it = shard.where.find(index); it != shard.where.end()) return it->second->second;
+
+            shard.order.emplace_front(index, data);
+            shard.where.emplace(index, shard.order.begin());
+
+            while (shard.order.size() > shard_capacity) {
+                shard.where.erase(shard.order.back().first);
+                shard.order.pop_back();
+                evictions.fetch_add(1, std::memory_order_relaxed);
+            }
+
+            return data;
+        }
+
+        /// url:https://man7.org/linux/man-pages/man2/pread.2.html
+        Data load(std::size_t index) const
+        {
+            auto offset = index * block;
+            auto data = std::make_shared<std::vector<char>>(std::min(block, length - offset));
+
+            for (std::size_t done = 0; done != data->size();) {
+                auto n = ::pread(descriptor.get(), data->data() + done, data->size() - done, static_cast<off_t>(offset + done));
+                if (n == -1 && errno == EINTR) continue;
+                if (n == -1) throw std::ios_base::failure("pread() == -1", std::error_code(errno, std::generic_category()));
+                if (n == 0) throw std::ios_base::failure("pread() == 0");
+                done += static_cast<std::size_t>(n);
+            }
+
+            return data;
+        }
+
+        std::filesystem::path path;
+        FileDescriptor descriptor;
+        std::size_t block;
+        std::size_t shard_count;
+        std::size_t shard_capacity;
+        std::unique_ptr<Shard[]> table;
+        std::size_t length = 0;
+        std::atomic<std::size_t> hits = 0;
+        std::atomic<std::size_t> misses = 0;
+        std::atomic<std::size_t> evictions = 0;
+    };
+
+
     /// Allows to write formatted text and numbers (and holds the number of written bytes).
     class FileWriter final {
       public:
@@ -188,7 +733,7 @@ namespace hlibs::io {
 
         /// url:https://en.cppreference.com/w/cpp/io/ios_base/openmode
         explicit FileWriter(const std::filesystem::path& p, std::ios_base::openmode mode = std::ios::trunc)
-                : path(p), file(p, mode)
+                : path(p), file(p, mode), appending(mode == std::ios::app)
         {
             bool isAllowedOpenMode = mode == std::ios::trunc || mode == std::ios::app || mode == std::ios::out;
 
@@ -197,9 +742,21 @@ namespace hlibs::io {
                 throw std::ios_base::failure("!isAllowedOpenMode || !isOpenedCorrectly");
             }
 
+            // opened along with the stream, so both name the same file even if the path is renamed, unlinked, or relative
+            // to a working directory that changes later
+            descriptor.emplace(p, appending ? O_WRONLY | O_APPEND : O_WRONLY);
             file.exceptions(std::ofstream::badbit);
         }
 
+        /// Compressing mode: everything written is stored as compressed frames of independent blocks, compressed on
+        /// up to options.threads threads at once; bytes() counts the uncompressed bytes. Appending adds a new frame.
+        FileWriter(const std::filesystem::path& p, std::ios_base::openmode mode, standard::compression::Frame options)
+                : FileWriter(p, mode)
+        {
+            compressor = std::make_unique<standard::compression::CompressingBuffer>(file.rdbuf(), options);
+            static_cast<std::ostream&>(file).rdbuf(compressor.get());
+        }
+
         FileWriter(const FileWriter& rhs) = delete;
         FileWriter& operator=(const FileWriter& rhs) = delete;
 
@@ -215,6 +772,44 @@ namespace hlibs::io {
             bytes_written += text.size();
         }
 
+        /// Writes the pieces as one record: small ones are copied into the stream buffer, while from
+        /// gather_threshold bytes on they are submitted straight from the caller's memory with pwritev().
+        void gather(std::span<const std::string_view> pieces)
+        {
+            std::size_t total = 0;
+            for (auto piece : pieces) total += piece.size();
+
+            if (total < gather_threshold || isFiltered()) {
+                for (auto piece : pieces) file.write(piece.data(), static_cast<std::streamsize>(piece.size()));
+                bytes_written += total;
+                return;
+            }
+
+            file.flush();
+            auto offset = static_cast<off_t>(file.tellp());
+            std::vector<iovec> vectors;
+            vectors.reserve(pieces.size());
+
+            for (auto piece : pieces) {
+                if (!piece.empty()) vectors.push_back(iovec{const_cast<char*>(piece.data()), piece.size()});
+            }
+
+            WriteVectors(handle(), vectors, appending ? -1 : offset);
+            bytes_written += total;
+
+            if (appending) {
+                file.seekp(0, std::ios::end);
+            }
+            else {
+                file.seekp(std::ofstream::off_type(offset) + std::ofstream::off_type(total), std::ios::beg);
+            }
+        }
+
+        void gather(std::initializer_list<std::string_view> pieces)
+        {
+            gather(std::span<const std::string_view>(pieces.begin(), pieces.size()));
+        }
+
         template<typename T>
         requires std::is_same_v<T, char> || std::is_same_v<T, signed char> || std::is_same_v<T, unsigned char>
         void put(T ch)
@@ -237,18 +832,14 @@ namespace hlibs::io {
             if (type == NewLine::Windows) ++bytes_written;
         }
 
+        /// Formats with std::to_chars on the stack; width, base, showbase, showpos, uppercase and adjustment follow std::num_put.
         template<typename T>
         requires std::numeric_limits<T>::is_integer
         void integer(T integer, std::ios_base::fmtflags flags = std::ios_base::dec, std::streamsize width = 0)
         {
-            std::ostringstream ss;
-            ss.flags(flags);
-            ss.width(width);
-            ss << integer;
-            auto str = ss.str();
-
-            file << str;
-            bytes_written += str.size();
+            std::array<char, 80> text{};
+            auto [length, prefix] = FormatInteger(text, integer, flags);
+            Align(Direct{*this}, std::string_view(text.data(), length), prefix, flags, width);
         }
 
         /// url:https://en.cppreference.com/w/cpp/io/ios_base/fmtflags
@@ -256,49 +847,82 @@ namespace hlibs::io {
         requires std::is_floating_point_v<T>
         void floating(T number, std::streamsize point = 8, std::ios_base::fmtflags flags = std::ios::fixed, std::streamsize width = 0)
         {
-            std::ostringstream ss;
-            ss.flags(flags);
-            ss.precision(point);
-            ss.width(width);
-            ss << number;
-            auto str = ss.str();
+            std::array<char, 512> text{};
+            auto [length, prefix] = FormatFloating(text, number, point, flags);
 
-            file << str;
-            bytes_written += str.size();
+            if (length == 0) {
+                Direct{*this}(Stringify(number, point, flags, width));
+                return;
+            }
+
+            Align(Direct{*this}, std::string_view(text.data(), length), prefix, flags, width);
         }
 
         void boolean(bool b, std::streamsize width = 0)
         {
-            std::ostringstream ss;
-            ss.width(width);
-            ss << std::boolalpha << b;
-            auto str = ss.str();
+            Align(Direct{*this}, b ? "true" : "false", 0, std::ios_base::right, width);
+        }
+
+        /// Writes all the numbers, separated, through a single stack block instead of one stream call per number.
+        template<typename T, std::size_t N>
+        requires std::numeric_limits<std::remove_cv_t<T>>::is_integer
+        void integers(std::span<T, N> numbers, std::string_view separator = " ", std::ios_base::fmtflags flags = std::ios_base::dec, std::streamsize width = 0)
+        {
+            Batch batch(*this);
+            std::array<char, 80> text{};
+
+            for (std::size_t i = 0; i != numbers.size(); ++i) {
+                if (i != 0) batch(separator);
+                auto [length, prefix] = FormatInteger(text, numbers[i], flags);
+                Align(batch, std::string_view(text.data(), length), prefix, flags, width);
+            }
+
+            batch.drain();
+        }
 
-            file << str;
-            bytes_written += str.size();
+        template<typename T, std::size_t N>
+        requires std::is_floating_point_v<std::remove_cv_t<T>>
+        void floatings(std::span<T, N> numbers, std::string_view separator = " ", std::streamsize point = 8, std::ios_base::fmtflags flags = std::ios::fixed, std::streamsize width = 0)
+        {
+            Batch batch(*this);
+            std::array<char, 512> text{};
+
+            for (std::size_t i = 0; i != numbers.size(); ++i) {
+                if (i != 0) batch(separator);
+                auto [length, prefix] = FormatFloating(text, numbers[i], point, flags);
+
+                if (length == 0) {
+                    batch(Stringify(numbers[i], point, flags, width));
+                    continue;
+                }
+
+                Align(batch, std::string_view(text.data(), length), prefix, flags, width);
+            }
+
+            batch.drain();
         }
 
         /// {"$Path","$FileAddress","$BytesWritten"}
         [[nodiscard]] std::string toString() const noexcept
         {
-            std::stringstream ss;
-            ss << '{';
-            ss << std::quoted(path.string()) << ',';
-            ss << '"' << &file << "\",";
-            ss << std::quoted(std::to_string(bytes_written));
-            ss << "}";
-            return ss.str();
+            facilities::formatting::StringBuilder<> builder;
+            builder << '{';
+            builder.appendQuoted(path.native());
+            builder << ",\"" << &file << "\",\"" << bytes_written << "\"}";
+            return builder.str();
         }
 
         /// url:https://en.cppreference.com/w/cpp/io/basic_ostream/tellp
         std::ofstream::pos_type position()
         {
+            if (isFiltered()) throw std::logic_error("position() when filtered");
             return file.tellp();
         }
 
         /// url:https://en.cppreference.com/w/cpp/io/ios_base/seekdir
         void position(std::ofstream::pos_type offset, std::ios::seekdir direction = std::ios::cur)
         {
+            if (isFiltered()) throw std::logic_error("position() when filtered");
             file.seekp(std::ofstream::off_type(offset), direction);
         }
 
@@ -312,10 +936,557 @@ namespace hlibs::io {
             return bytes_written;
         }
 
+        /// Copies length bytes (the whole rest by default) from the offset of the source file to the current position,
+        /// inside the kernel where the file systems allow it and otherwise through a bounded buffer.
+        std::size_t transfer(const std::filesystem::path& source, off_t offset = 0, std::size_t length = std::numeric_limits<std::size_t>::max(),
+                             const TransferProgress& progress = {})
+        {
+            FileDescriptor in(source);
+            struct stat status{};
+            if (::fstat(in.get(), &status) == -1) throw std::ios_base::failure("fstat()", std::error_code(errno, std::generic_category()));
+            if (offset < 0) throw std::invalid_argument("offset < 0");
+
+            auto available = offset < status.st_size ? static_cast<std::size_t>(status.st_size - offset) : 0;
+            auto count = std::min(length, available);
+
+            if (isFiltered()) {
+                std::array<char, 1UL << 16> buffer{};
+                std::size_t copied = 0;
+
+                while (copied != count) {
+                    auto n = ::pread(in.get(), buffer.data(), std::min(buffer.size(), count - copied), offset);
+                    if (n < 0 && errno == EINTR) continue;
+                    if (n < 0) throw std::ios_base::failure("pread()", std::error_code(errno, std::generic_category()));
+                    if (n == 0) break;
+                    file.write(buffer.data(), n);
+                    offset += n;
+                    copied += static_cast<std::size_t>(n);
+                    if (progress) progress(copied, count);
+                }
+
+                bytes_written += copied;
+                return copied;
+            }
+
+            file.flush();
+            auto position = static_cast<off_t>(file.tellp());
+            auto copied = CopyBytes(in.get(), &offset, handle(), appending ? nullptr : &position, count, progress);
+            bytes_written += copied;
+
+            if (appending) {
+                file.seekp(0, std::ios::end);
+            }
+            else {
+                file.seekp(std::ofstream::off_type(position), std::ios::beg);
+            }
+
+            return copied;
+        }
+
+        /// Feeds the checksum with the bytes written from now on (before compression, if any); it is up to date
+        /// after sync() or once the writer is destroyed. Large gather() and transfer() calls then go through the stream.
+        /// Only one checksum per writer.
+        template<facilities::hashing::Checksum T>
+        void checksum(T& sum)
+        {
+            if (checksummer) throw std::logic_error("checksum() twice");
+            auto& stream = static_cast<std::ostream&>(file);
+            checksummer = std::make_unique<facilities::hashing::ChecksumBuffer<T>>(stream.rdbuf(), sum);
+            stream.rdbuf(checksummer.get());
+        }
+
+        /// From this many bytes on, gather() bypasses the stream buffer.
+        static constexpr std::size_t gather_threshold = 1UL << 14;
+
+      private:
+        /// A second descriptor of the same file (opened with the stream) for the vectored writes and transfers.
+        int handle() const noexcept
+        {
+            return descriptor->get();
+        }
+
+        /// Whether the bytes pass through a filter (compression or checksum) that the file descriptor would bypass.
+        inline bool isFiltered() const noexcept
+        {
+            return compressor || checksummer;
+        }
+
+        /// Repeats pwritev() (or writev() when offset is negative) until every vector is written, at most IOV_MAX per call.
+        static void WriteVectors(int fd, std::vector<iovec>& vectors, off_t offset)
+        {
+            std::size_t first = 0;
+
+            while (first != vectors.size()) {
+                auto count = static_cast<int>(std::min<std::size_t>(vectors.size() - first, IOV_MAX));
+                auto written = offset < 0 ? ::writev(fd, &vectors[first], count) : ::pwritev(fd, &vectors[first], count, offset);
+
+                if (written == -1) {
+                    if (errno == EINTR) continue;
+                    throw std::ios_base::failure("pwritev()", std::error_code(errno, std::generic_category()));
+                }
+
+                if (offset >= 0) offset += written;
+                auto left = static_cast<std::size_t>(written);
+
+                while (first != vectors.size() && left >= vectors[first].iov_len) {
+                    left -= vectors[first].iov_len;
+                    ++first;
+                }
+
+                if (left != 0) {
+                    vectors[first].iov_base = static_cast<char*>(vectors[first].iov_base) + left;
+                    vectors[first].iov_len -= left;
+                }
+            }
+        }
+
+        /// Length of the formatted text and of its sign and base prefix (the spot of internal padding).
+        struct Formatted {
+            std::size_t length;
+            std::size_t prefix;
+        };
+
+        /// Passes pieces straight to the stream.
+        struct Direct {
+            FileWriter& writer;
+
+            void operator()(std::string_view text) const
+            {
+                writer.file.write(text.data(), static_cast<std::streamsize>(text.size()));
+                writer.bytes_written += text.size();
+            }
+        };
+
+        /// Collects small pieces into a stack block that is written out at once.
+        class Batch {
+          public:
+            explicit Batch(FileWriter& w): writer(w) {}
+
+            void operator()(std::string_view text)
+            {
+                if (block.size() - used < text.size()) drain();
+
+                if (text.size() > block.size()) {
+                    Direct{writer}(text);
+                    return;
+                }
+
+                std::memcpy(block.data() + used, text.data(), text.size());
+                used += text.size();
+            }
+
+            void drain()
+            {
+                Direct{writer}(std::string_view(block.data(), used));
+                used = 0;
+            }
+
+          private:
+            FileWriter& writer;
+            std::array<char, 8192> block;
+            std::size_t used = 0;
+        };
+
+
+        /// Pads with spaces to the width: after the text (left), after the prefix (internal), or before it (right).
+        template<typename Out>
+        static void Align(Out&& out, std::string_view text, std::size_t prefix, std::ios_base::fmtflags flags, std::streamsize width)
+        {
+            static constexpr std::string_view spaces = "                                ";
+            auto padding = width > 0 && static_cast<std::size_t>(width) > text.size() ? static_cast<std::size_t>(width) - text.size() : 0UL;
+            auto adjustment = flags & std::ios_base::adjustfield;
+
+            auto pad = [&out, padding]() {
+                for (auto rest = padding; rest != 0;) {
+                    auto chunk = std::min(rest, spaces.size());
+                    out(spaces.substr(0, chunk));
+                    rest -= chunk;
+                }
+            };
+
+            if (adjustment == std::ios_base::left) {
+                out(text);
+                pad();
+            }
+            else if (adjustment == std::ios_base::internal) {
+                out(text.substr(0, prefix));
+                pad();
+                out(text.substr(prefix));
+            }
+            else {
+                pad();
+                out(text);
+            }
+        }
+
+        /// Characters are put as they are and booleans honour boolalpha, as operator<< does.
+        template<typename T, std::size_t N>
+        static Formatted FormatInteger(std::array<char, N>& out, T integer, std::ios_base::fmtflags flags) noexcept
+        {
+            using U = std::remove_cv_t<T>;
+            char* first = out.data();
+            char* cursor = first;
+
+            if constexpr (std::is_same_v<U, bool>) {
+                std::string_view text = (flags & std::ios_base::boolalpha) ? (integer ? "true" : "false") : (integer ? "1" : "0");
+                std::ranges::copy(text, first);
+                return {text.size(), 0};
+            }
+            else if constexpr (std::is_same_v<U, char> || std::is_same_v<U, signed char> || std::is_same_v<U, unsigned char>) {
+                *first = static_cast<char>(integer);
+                return {1, 0};
+            }
+            else {
+                auto basefield = flags & std::ios_base::basefield;
+
+                if (basefield == std::ios_base::oct || basefield == std::ios_base::hex) {
+                    auto value = static_cast<std::make_unsigned_t<U>>(integer);
+                    bool isHex = basefield == std::ios_base::hex;
+
+                    if ((flags & std::ios_base::showbase) && value != 0) {
+                        *cursor++ = '0';
+                        if (isHex) *cursor++ = (flags & std::ios_base::uppercase) ? 'X' : 'x';
+                    }
+
+                    // internal padding goes after "0x", but before the leading '0' of an octal number
+                    auto prefix = isHex ? static_cast<std::size_t>(cursor - first) : 0UL;
+                    auto [end, ec] = std::to_chars(cursor, out.data() + N, value, isHex ? 16 : 8);
+                    if (flags & std::ios_base::uppercase) std::transform(cursor, end, cursor, Upper);
+                    return {static_cast<std::size_t>(end - first), prefix};
+                }
+
+                if (integer < 0) {
+                    *cursor++ = '-';
+                }
+                else if (std::is_signed_v<U> && (flags & std::ios_base::showpos)) {
+                    *cursor++ = '+';
+                }
+
+                auto magnitude = static_cast<std::make_unsigned_t<U>>(integer);
+                if (integer < 0) magnitude = static_cast<std::make_unsigned_t<U>>(0U - magnitude);
+                auto [end, ec] = std::to_chars(cursor, out.data() + N, magnitude);
+                return {static_cast<std::size_t>(end - first), static_cast<std::size_t>(cursor - first)};
+            }
+        }
+
+        /// Fixed, scientific, hexfloat (fixed|scientific) or general notation; zero length when the stream fallback is needed.
+        template<typename T, std::size_t N>
+        static Formatted FormatFloating(std::array<char, N>& out, T number, std::streamsize point, std::ios_base::fmtflags flags) noexcept
+        {
+            if (flags & std::ios_base::showpoint) return {0, 0};
+
+            char* first = out.data();
+            char* cursor = first;
+            auto floatfield = flags & std::ios_base::floatfield;
+            auto precision = static_cast<int>(point < 0 ? 6 : point);
+            std::to_chars_result result{};
+
+            if (std::signbit(number)) {
+                *cursor++ = '-';
+                number = -number;
+            }
+            else if (flags & std::ios_base::showpos) {
+                *cursor++ = '+';
+            }
+
+            // internal padding goes after the sign, or after "0x" when there is no sign (as in std::num_put)
+            auto prefix = static_cast<std::size_t>(cursor - first);
+
+            if (floatfield == std::ios_base::floatfield) {
+                if (std::isfinite(number)) {
+                    *cursor++ = '0';
+                    *cursor++ = 'x';
+                    if (prefix == 0) prefix = 2;
+                }
+
+                result = std::to_chars(cursor, out.data() + N, number, std::chars_format::hex);
+            }
+            else if (floatfield == std::ios_base::fixed) {
+                result = std::to_chars(cursor, out.data() + N, number, std::chars_format::fixed, precision);
+            }
+            else if (floatfield == std::ios_base::scientific) {
+                result = std::to_chars(cursor, out.data() + N, number, std::chars_format::scientific, precision);
+            }
+            else {
+                result = std::to_chars(cursor, out.data() + N, number, std::chars_format::general, precision);
+            }
+
+            if (result.ec != std::errc{}) return {0, 0};
+            if ((flags & std::ios_base::uppercase) && floatfield != std::ios_base::fixed) std::transform(first, result.ptr, first, Upper);   // %f has no upper case
+            return {static_cast<std::size_t>(result.ptr - first), prefix};
+        }
+
+        /// The formatting of std::ostream, for what std::to_chars cannot express.
+        template<typename T>
+        static std::string Stringify(T number, std::streamsize point, std::ios_base::fmtflags flags, std::streamsize width)
+        {
+            std::ostringstream ss;
+            ss.flags(flags);
+            ss.precision(point);
+            ss.width(width);
+            ss << number;
+            return ss.str();
+        }
+
+        static char Upper(char ch) noexcept
+        {
+            return ch >= 'a' && ch <= 'z' ? static_cast<char>(ch - 'a' + 'A') : ch;
+        }
+
+        std::filesystem::path path;
+        std::ofstream file;
+        std::size_t bytes_written = 0;
+        bool appending;
+        std::optional<FileDescriptor> descriptor{};
+        std::unique_ptr<standard::compression::CompressingBuffer> compressor{};    ///< ends its frame before the file is closed
+        std::unique_ptr<std::streambuf> checksummer{};                             ///< hands its chunk over before the compressor ends
+    };
+
+
+    /// When to flush FileWriterBuffered: a zero threshold disables the trigger; the age of buffered data is checked on write
+    /// and, with a background thread, by that thread as well, so data written before the producer goes idle is not held back.
+    struct FlushPolicy {
+        std::size_t bytes = 0;
+        std::size_t messages = 0;
+        std::chrono::milliseconds interval{0};
+    };
+
+
+    /// Gathers writes in a user-sized buffer and flushes it once a byte, message count, or age threshold is reached.
+    /// With act_on_thread the producer only swaps buffers, while a background thread performs the file write.
+    class FileWriterBuffered final {
+      public:
+        explicit FileWriterBuffered(const std::filesystem::path& p, std::size_t capacity = 1UL << 16, FlushPolicy policy = {},
+                                    bool act_on_thread = false, std::ios_base::openmode mode = std::ios::trunc)
+                : path(p), front(std::max<std::size_t>(capacity, 1)), back(front.size()), rule(policy)
+        {
+            bool isAllowedOpenMode = mode == std::ios::trunc || mode == std::ios::app || mode == std::ios::out;
+            file.rdbuf()->pubsetbuf(nullptr, 0);
+            file.open(p, mode | std::ios::binary);
+
+            if (bool isOpenedCorrectly = file.is_open() && file.good(); !isAllowedOpenMode || !isOpenedCorrectly) {
+                file.close();
+                throw std::ios_base::failure("!isAllowedOpenMode || !isOpenedCorrectly");
+            }
+
+            file.exceptions(std::ofstream::badbit);
+            if (act_on_thread) worker = std::jthread([this](std::stop_token token) { run(token); });
+        }
+
+        FileWriterBuffered(const FileWriterBuffered& rhs) = delete;
+        FileWriterBuffered& operator=(const FileWriterBuffered& rhs) = delete;
+
+        FileWriterBuffered(FileWriterBuffered&& rhs) noexcept = delete;
+        FileWriterBuffered& operator=(FileWriterBuffered&& rhs) noexcept = delete;
+
+        /// The background thread (if any) is joined only after the last buffer has been written.
+        ~FileWriterBuffered() noexcept
+        {
+            try {
+                sync();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "~FileWriterBuffered->exception: " << e.what();
+            }
+        }
+
+        void write(std::string_view text)
+        {
+            std::unique_lock lock(mutex, std::defer_lock);
+            if (isTimed()) lock.lock();     // the background thread may hand over a stale front buffer meanwhile
+
+            if (used + text.size() > front.size()) handOver(lock);
+
+            if (text.size() > front.size()) {
+                settle(lock);
+                drain(text.data(), text.size());
+            }
+            else {
+                if (used == 0 && rule.interval.count() != 0) since = std::chrono::steady_clock::now();
+                std::memcpy(front.data() + used, text.data(), text.size());
+                used += text.size();
+            }
+
+            bytes_written += text.size();
+            ++messages;
+            if (isFlushDue()) handOver(lock);
+        }
+
+        void put(char ch)
+        {
+            write(std::string_view(&ch, 1));
+        }
+
+        /// Hands the buffered bytes over to the file (or to the background thread).
+        void flush()
+        {
+            std::unique_lock lock(mutex, std::defer_lock);
+            handOver(lock);
+        }
+
+        /// Flushes, waits for the background write to finish, and flushes the stream itself.
+        void sync()
+        {
+            std::unique_lock lock(mutex, std::defer_lock);
+            handOver(lock);
+            settle(lock);
+            file.flush();
+        }
+
+        inline std::size_t bytes() const noexcept
+        {
+            return bytes_written;
+        }
+
+        inline std::size_t flushes() const noexcept
+        {
+            return flush_count.load(std::memory_order_relaxed);
+        }
+
+        inline std::size_t bytesPerFlush() const noexcept
+        {
+            auto count = flushes();
+            return count == 0 ? 0 : flushed_bytes.load(std::memory_order_relaxed) / count;
+        }
+
+        /// {"$Path","$BytesWritten","$Flushes","$BytesPerFlush"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            facilities::formatting::StringBuilder<> builder;
+            builder << '{';
+            builder.appendQuoted(path.native());
+            builder << ",\"" << bytes_written << "\",\"" << flushes() << "\",\"" << bytesPerFlush() << "\"}";
+            return builder.str();
+        }
+
       private:
+        /// Whether the background thread flushes stale data too, so the front buffer is shared with it under the mutex.
+        bool isTimed() const noexcept
+        {
+            return worker.joinable() && rule.interval.count() != 0;
+        }
+
+        /// Body of flush(); the lock (of the mutex) is left as it was given.
+        void handOver(std::unique_lock<std::mutex>& lock)
+        {
+            if (!worker.joinable()) {
+                if (used == 0) return;
+                drain(front.data(), used);
+                used = 0;
+                messages = 0;
+                return;
+            }
+
+            const bool owned = lock.owns_lock();
+            if (!owned) lock.lock();
+
+            if (used != 0) {
+                handover.wait(lock, [this] { return !pending; });
+                rethrow();
+
+                if (used != 0) {    // unless the background thread took the buffer as stale while this one waited
+                    swap();
+                    handover.notify_all();
+                }
+            }
+
+            if (!owned) lock.unlock();
+        }
+
+        /// Passes the front buffer to the background thread; the mutex must be held and no buffer pending.
+        void swap() noexcept
+        {
+            std::swap(front, back);
+            back_used = used;
+            pending = true;
+            used = 0;
+            messages = 0;
+        }
+
+        bool isFlushDue() const noexcept
+        {
+            bool isBytesDue = rule.bytes != 0 && used >= rule.bytes;
+            bool isMessagesDue = rule.messages != 0 && messages >= rule.messages;
+            bool isIntervalDue = rule.interval.count() != 0 && used != 0 && std::chrono::steady_clock::now() - since >= rule.interval;
+            return isBytesDue || isMessagesDue || isIntervalDue;
+        }
+
+        void drain(const char* data, std::size_t count)
+        {
+            file.write(data, static_cast<std::streamsize>(count));
+            flush_count.fetch_add(1, std::memory_order_relaxed);
+            flushed_bytes.fetch_add(count, std::memory_order_relaxed);
+        }
+
+        /// Waits until the background thread is idle and passes on its failure, if any; the lock is left as it was given.
+        void settle(std::unique_lock<std::mutex>& lock)
+        {
+            if (!worker.joinable()) return;
+
+            const bool owned = lock.owns_lock();
+            if (!owned) lock.lock();
+            handover.wait(lock, [this] { return !pending; });
+            rethrow();
+            if (!owned) lock.unlock();
+        }
+
+        void rethrow()
+        {
+            if (!failure) return;
+            auto e = std::exchange(failure, nullptr);
+            std::rethrow_exception(e);
+        }
+
+        /// Writes the buffers handed over; with an interval, it also hands over a front buffer over that age by itself.
+        void run(std::stop_token token)
+        {
+            std::unique_lock lock(mutex);
+
+            while (!token.stop_requested()) {
+                if (rule.interval.count() == 0) {
+                    if (!handover.wait(lock, token, [this] { return pending; })) break;
+                }
+                else {
+                    auto deadline = used != 0 ? since + rule.interval : std::chrono::steady_clock::now() + rule.interval;
+                    handover.wait_until(lock, token, deadline, [this] { return pending; });
+
+                    bool isStale = used != 0 && std::chrono::steady_clock::now() - since >= rule.interval;
+                    if (!pending && isStale) swap();
+                    if (!pending) continue;
+                }
+
+                lock.unlock();
+
+                try {
+                    drain(back.data(), back_used);
+                }
+                catch (...) {
+                    failure = std::current_exception();
+                }
+
+                lock.lock();
+                pending = false;
+                handover.notify_all();
+            }
+        }
+
         std::filesystem::path path;
         std::ofstream file;
+        std::vector<char> front;
+        std::vector<char> back;
+        std::size_t used = 0;
+        std::size_t back_used = 0;
+        std::size_t messages = 0;
         std::size_t bytes_written = 0;
+        FlushPolicy rule;
+        std::chrono::steady_clock::time_point since{};
+        std::atomic<std::size_t> flush_count = 0;
+        std::atomic<std::size_t> flushed_bytes = 0;
+        std::mutex mutex;
+        std::condition_variable_any handover;
+        bool pending = false;
+        std::exception_ptr failure = nullptr;
+        std::jthread worker;    ///< declared last to be joined before the rest is destroyed
     };
 
 
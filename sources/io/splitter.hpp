@@ -0,0 +1,390 @@
+#ifndef LIBS_SPLITTER_HPP
+#define LIBS_SPLITTER_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <memory>
+#include <filesystem>
+#include <functional>
+#include <sstream>
+#include <iomanip>
+#include <thread>
+#include <stdexcept>
+#include <algorithm>
+#include <deque>
+#include <span>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+#include "./helper_objects.hpp"
+
+
+namespace hlibs::io {
+
+    /// Names the split files as "{$prefix}${name}{$suffix}_{$file_no}.{$ext}" inside the folder, e.g. "log_LIBS_1.txt".
+    struct SplitterScheme {
+        std::filesystem::path folder = std::filesystem::current_path();
+        std::string prefix{};
+        std::string name{};
+        std::string suffix{};
+        std::string extension = "txt";
+
+        [[nodiscard]] std::filesystem::path at(std::size_t file_no) const
+        {
+            auto filename = prefix + name + suffix + '_' + std::to_string(file_no) + '.' + extension;
+            return folder / filename;
+        }
+    };
+
+
+    /// Spreads records over a number of files, each written by its own background thread and rolled over to the next
+    /// file number once it would exceed the size limit. Lane i writes the file numbers i + 1, i + 1 + files, i + 1 + 2 * files, ...
+    class SplitterWriter final {
+      public:
+        explicit SplitterWriter(SplitterScheme naming, std::size_t files = std::max(1U, std::thread::hardware_concurrency()),
+                                std::size_t limit = 1UL << 26, std::size_t capacity = 1UL << 20)
+                : scheme(std::move(naming)), size_limit(limit), buffer_size(capacity), lanes(files)
+        {
+            if (files == 0) throw std::invalid_argument("files == 0");
+            if (limit == 0) throw std::invalid_argument("limit == 0");
+            if (!std::filesystem::is_directory(scheme.folder)) throw std::invalid_argument("!is_directory(scheme.folder)");
+
+            for (std::size_t i = 0; i != lanes.size(); ++i) roll(i);
+        }
+
+        SplitterWriter(const SplitterWriter& rhs) = delete;
+        SplitterWriter& operator=(const SplitterWriter& rhs) = delete;
+
+        SplitterWriter(SplitterWriter&& rhs) noexcept = delete;
+        SplitterWriter& operator=(SplitterWriter&& rhs) noexcept = delete;
+
+        /// Closes the files and releases the blocks reserved past their ends.
+        ~SplitterWriter() noexcept
+        {
+            for (auto& lane : lanes) close(lane);
+        }
+
+        /// Round-robin over the files.
+        void write(std::string_view record)
+        {
+            append(next++ % lanes.size(), record);
+        }
+
+        /// Records of equal keys always land in the same sequence of files.
+        void write(std::string_view key, std::string_view record)
+        {
+            append(std::hash<std::string_view>{}(key) % lanes.size(), record);
+        }
+
+        /// Waits until every background thread has written out its buffer.
+        void sync()
+        {
+            for (auto& lane : lanes) lane.writer->sync();
+        }
+
+        inline std::size_t bytes() const noexcept
+        {
+            return bytes_written;
+        }
+
+        /// Paths of all the files created so far, by file number.
+        [[nodiscard]] std::vector<std::filesystem::path> paths() const
+        {
+            std::vector<std::filesystem::path> all;
+            std::size_t last = 0;
+
+            for (std::size_t i = 0; i != lanes.size(); ++i) {
+                last = std::max(last, number(i, lanes[i].generation));
+            }
+
+            for (std::size_t file_no = 1; file_no <= last; ++file_no) {
+                const auto& lane = lanes[(file_no - 1) % lanes.size()];
+                if ((file_no - 1) / lanes.size() <= lane.generation) all.push_back(scheme.at(file_no));
+            }
+
+            return all;
+        }
+
+        /// {"$FirstFilePath","$NumberOfFiles","$BytesWritten"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            std::size_t count = 0;
+            for (const auto& lane : lanes) count += lane.generation + 1;
+
+            std::stringstream ss;
+            ss << '{';
+            ss << std::quoted(scheme.at(1).string()) << ',';
+            ss << std::quoted(std::to_string(count)) << ',';
+            ss << std::quoted(std::to_string(bytes_written));
+            ss << '}';
+            return ss.str();
+        }
+
+      private:
+        struct Lane {
+            std::size_t generation = 0;
+            std::size_t used = 0;
+            std::filesystem::path path{};
+            std::unique_ptr<FileWriterBuffered> writer{};
+        };
+
+        void append(std::size_t index, std::string_view record)
+        {
+            auto& lane = lanes[index];
+
+            if (lane.used != 0 && lane.used + record.size() > size_limit) {
+                ++lane.generation;
+                roll(index);
+            }
+
+            lane.writer->write(record);
+            lane.used += record.size();
+            bytes_written += record.size();
+        }
+
+        /// Closes the current file of the lane (the old writer joins its thread) and opens the next one.
+        void roll(std::size_t index)
+        {
+            auto& lane = lanes[index];
+            close(lane);
+
+            lane.path = scheme.at(number(index, lane.generation));
+            lane.writer = std::make_unique<FileWriterBuffered>(lane.path, buffer_size, FlushPolicy{}, true);
+            lane.used = 0;
+            Preallocate(lane.path, size_limit);
+        }
+
+        void close(Lane& lane) noexcept
+        {
+            if (!lane.writer) return;
+            lane.writer.reset();
+            Release(lane.path);
+        }
+
+        std::size_t number(std::size_t index, std::size_t generation) const noexcept
+        {
+            return 1 + index + generation * lanes.size();
+        }
+
+        /// Reserves the blocks up front (without changing the file size) to keep the file contiguous; a hint only.
+        static void Preallocate(const std::filesystem::path& path, std::size_t size) noexcept
+        {
+#if defined(__linux__)
+            int fd = ::open(path.c_str(), O_WRONLY);
+            if (fd == -1) return;
+            [[maybe_unused]] int rc = ::fallocate(fd, FALLOC_FL_KEEP_SIZE, 0, static_cast<off_t>(size));
+            ::close(fd);
+#endif
+        }
+
+        /// Frees the blocks preallocated past the end of a closed file (truncating it to its own size drops them; punching a
+        /// hole past the end is ignored by ext4), so it does not keep up to size_limit reserved on disk.
+        static void Release(const std::filesystem::path& path) noexcept
+        {
+#if defined(__linux__)
+            int fd = ::open(path.c_str(), O_WRONLY);
+            if (fd == -1) return;
+
+            struct stat stat_buffer{};
+            if (::fstat(fd, &stat_buffer) == 0) {
+                [[maybe_unused]] int rc = ::ftruncate(fd, stat_buffer.st_size);
+            }
+
+            ::close(fd);
+#endif
+        }
+
+        SplitterScheme scheme;
+        std::size_t size_limit;
+        std::size_t buffer_size;
+        std::vector<Lane> lanes;
+        std::size_t next = 0;
+        std::size_t bytes_written = 0;
+    };
+
+
+    /// Reads an ordered list of files as one continuous stream of bytes or lines. A background thread opens the next
+    /// files and reads chunks ahead (up to depth of them) while the current ones are consumed.
+    class SplitterReader final {
+      public:
+        explicit SplitterReader(std::vector<std::filesystem::path> files, std::size_t chunk = 1UL << 20, std::size_t depth = 4)
+                : sequence(std::move(files)), chunk_size(std::max<std::size_t>(chunk, 1)), queue_depth(std::max<std::size_t>(depth, 1))
+        {
+            for (const auto& file : sequence) {
+                if (!std::filesystem::is_regular_file(file)) throw std::ios::failure("!is_regular_file(file)");
+            }
+        }
+
+        SplitterReader(const SplitterReader& rhs) = delete;
+        SplitterReader& operator=(const SplitterReader& rhs) = delete;
+
+        SplitterReader(SplitterReader&& rhs) noexcept = delete;
+        SplitterReader& operator=(SplitterReader&& rhs) noexcept = delete;
+
+        ~SplitterReader() noexcept = default;
+
+        bool hasNextLine()
+        {
+            return ensure();
+        }
+
+        /// A line may continue from one file into the next one when the former does not end with a line break.
+        std::string getNextLine()
+        {
+            std::string line;
+
+            while (ensure()) {
+                auto rest = std::string_view(current.data() + cursor, current.size() - cursor);
+                auto end = rest.find('\n');
+
+                if (end != std::string_view::npos) {
+                    line.append(rest.substr(0, end));
+                    cursor += end + 1;
+                    break;
+                }
+
+                line.append(rest);
+                cursor = current.size();
+            }
+
+            ++lines_read;
+            return line;
+        }
+
+        /// Copies the next bytes of the sequence; fewer than requested only at its end.
+        std::size_t read(std::span<char> out)
+        {
+            std::size_t count = 0;
+
+            while (count != out.size() && ensure()) {
+                auto n = std::min(out.size() - count, current.size() - cursor);
+                std::memcpy(out.data() + count, current.data() + cursor, n);
+                cursor += n;
+                count += n;
+            }
+
+            return count;
+        }
+
+        /// Hands the whole sequence to the writer, file by file, copied inside the kernel where possible.
+        /// It must be called instead of reading, not after reading has started.
+        std::size_t copyTo(FileWriter& writer)
+        {
+            if (worker.joinable()) throw std::logic_error("copyTo() after reading");
+
+            std::size_t copied = 0;
+            for (const auto& file : sequence) copied += writer.transfer(file);
+            finished = true;
+            return copied;
+        }
+
+        inline std::size_t lines() const noexcept
+        {
+            return lines_read;
+        }
+
+        /// {"$NumberOfFiles","$NumberOfLinesRead"}
+        [[nodiscard]] std::string toString() const noexcept
+        {
+            std::stringstream ss;
+            ss << '{';
+            ss << std::quoted(std::to_string(sequence.size())) << ',';
+            ss << std::quoted(std::to_string(lines_read));
+            ss << '}';
+            return ss.str();
+        }
+
+      private:
+        /// Makes unread bytes available in the current chunk, waiting for the prefetching thread if needed.
+        bool ensure()
+        {
+            if (cursor < current.size()) return true;
+            if (finished) return false;
+            if (!worker.joinable()) worker = std::jthread([this](std::stop_token token) { prefetch(token); });
+
+            std::unique_lock lock(mutex);
+            spare = std::move(current);
+            ready.wait(lock, [this] { return !chunks.empty() || exhausted; });
+
+            if (chunks.empty()) {
+                finished = true;
+                current.clear();
+                cursor = 0;
+                if (failure) std::rethrow_exception(std::exchange(failure, nullptr));
+                return false;
+            }
+
+            current = std::move(chunks.front());
+            chunks.pop_front();
+            cursor = 0;
+            lock.unlock();
+            ready.notify_all();
+            return true;
+        }
+
+        void prefetch(std::stop_token token)
+        {
+            try {
+                for (const auto& file : sequence) {
+                    FileDescriptor in(file);
+                    ::posix_fadvise(in.get(), 0, 0, POSIX_FADV_SEQUENTIAL);
+
+                    while (!token.stop_requested()) {
+                        std::vector<char> chunk;
+
+                        {
+                            std::scoped_lock lock(mutex);
+                            chunk = std::move(spare);
+                        }
+
+                        chunk.resize(chunk_size);
+                        auto n = ::read(in.get(), chunk.data(), chunk.size());
+
+                        if (n < 0 && errno == EINTR) continue;
+                        if (n < 0) throw std::ios::failure("read()", std::error_code(errno, std::generic_category()));
+                        if (n == 0) break;
+                        chunk.resize(static_cast<std::size_t>(n));
+
+                        std::unique_lock lock(mutex);
+                        if (!ready.wait(lock, token, [this] { return chunks.size() < queue_depth; })) return;
+                        chunks.push_back(std::move(chunk));
+                        lock.unlock();
+                        ready.notify_all();
+                    }
+                }
+            }
+            catch (...) {
+                std::scoped_lock lock(mutex);
+                failure = std::current_exception();
+            }
+
+            std::scoped_lock lock(mutex);
+            exhausted = true;
+            ready.notify_all();
+        }
+
+        std::vector<std::filesystem::path> sequence;
+        std::size_t chunk_size;
+        std::size_t queue_depth;
+        std::vector<char> current{};
+        std::vector<char> spare{};
+        std::size_t cursor = 0;
+        std::size_t lines_read = 0;
+        bool finished = false;
+        std::deque<std::vector<char>> chunks{};
+        std::mutex mutex;
+        std::condition_variable_any ready;
+        bool exhausted = false;
+        std::exception_ptr failure = nullptr;
+        std::jthread worker;    ///< declared last to be joined before the rest is destroyed
+    };
+
+}
+
+#endif //LIBS_SPLITTER_HPP
@@ -14,6 +14,8 @@
 #include <iostream>
 
 #include "../facilities/strings.hpp"
+#include "../facilities/interning.hpp"
+#include "../facilities/formatting.hpp"
 #include "../facilities/timestamp.hpp"
 #include "../io/helper_objects.hpp"
 
@@ -35,6 +37,11 @@ namespace hlibs::logging {
             return items.at(level);
         }
 
+        std::string_view name(Severity level) const noexcept
+        {
+            return items.at(level);
+        }
+
       private:
         std::unordered_map<Severity, std::string> items = {
                 {Severity::Exception, "Exception"},
@@ -54,42 +61,37 @@ namespace hlibs::logging {
         /// ${Header}$Message$NewLine
         Message(Level::Severity level, std::string_view msg, const Source& location)
         {
-            auto head = Header(level, location);
-            str.append(head);
-            str.append(msg);
-            str.append("\n");
+            Builder builder;
+            Header(builder, level, location);
+            builder.append(msg).append('\n');
+            str = builder.view();
         }
 
         /// ${Header}std::exception->$Type | $What | $Message$NewLine
         Message(std::string_view msg, const std::exception& e, const Source& location)
         {
-            auto head = Header(Level::Severity::Exception, location);
-            auto typeID = std::string(typeid(e).name());
-            auto tail = "std::exception->" + typeID + " | what: " + e.what() + " | ";
-            str.append(head);
-            str.append(tail);
-            str.append(msg);
-            str.append("\n");
+            Builder builder;
+            Header(builder, Level::Severity::Exception, location);
+            builder << "std::exception->" << typeid(e).name() << " | what: " << e.what() << " | ";
+            builder.append(msg).append('\n');
+            str = builder.view();
         }
 
       private:
-        static std::string Header(Level::Severity lv, const Source& source)
-        {
-            static Level severity;
-            hlibs::facilities::timestamp::DateTime marker;
+        using Builder = hlibs::facilities::formatting::StringBuilder<512>;
 
-            std::string timestamp = marker.timestamp();
-            std::string level = hlibs::facilities::strings::ToUpperCase(severity.toString(lv));
-            std::string path = source.file_name();
-            std::string file = path.substr(path.find_last_of("/\\") + 1);
-            std::string line = std::to_string(source.line());
-            std::string function = source.function_name();
+        /// The message is formatted in place and copied once, into str.
+        static void Header(Builder& builder, Level::Severity lv, const Source& source)
+        {
+            static const Level severity;
+            const hlibs::facilities::timestamp::DateTime marker;
+            const auto& site = hlibs::facilities::interning::SiteOf(source);
+            auto level = severity.name(lv);
 
             // $Date $Time [$Level] $SourceFile($Line) @"$FunctionPrototype": ${Message}
-            std::string header{};
-            header.append(timestamp + " [" + level + "] ");
-            header.append(file + '(' + line + ") @\"" + function + "\": ");
-            return header;
+            builder << marker.date << ' ' << marker.time << " [";
+            hlibs::facilities::strings::ToUpperCase(level, builder.extend(level.size()));
+            builder << "] " << site.file << '(' << source.line() << ") @\"" << site.function << "\": ";
         }
     };
 
@@ -125,11 +127,9 @@ namespace hlibs::logging {
         /// {"$NumberOfMessages"}
         [[nodiscard]] std::string toString() const noexcept
         {
-            std::ostringstream ss;
-            ss << '{';
-            ss << std::quoted(std::to_string(messages.size()));
-            ss << '}';
-            return ss.str();
+            facilities::formatting::StringBuilder<32> builder;
+            builder << "{\"" << messages.size() << "\"}";
+            return builder.str();
         }
 
         [[nodiscard]] std::string last() const
@@ -184,7 +184,9 @@ namespace hlibs::logging {
         /// {{"$NumberOfMessages"}}
         [[nodiscard]] std::string toString() const noexcept
         {
-            return '{' + sink.toString() + '}';
+            facilities::formatting::StringBuilder<64> builder;
+            builder << '{' << sink.toString() << '}';
+            return builder.str();
         }
 
       private:
@@ -250,7 +252,9 @@ namespace hlibs::logging {
         /// {{"$NumberOfMessages"}}
         [[nodiscard]] std::string toString() const noexcept
         {
-            return '{' + sink.toString() + '}';
+            facilities::formatting::StringBuilder<64> builder;
+            builder << '{' << sink.toString() << '}';
+            return builder.str();
         }
 
       private:
@@ -328,12 +332,9 @@ namespace hlibs::logging {
         /// {{$InMemoryLogger},{$FileWriter}}
         std::string toString() const noexcept
         {
-            std::ostringstream ss;
-            ss << '{';
-            ss << sink.toString() << ',';
-            ss << writer.toString();
-            ss << '}';
-            return ss.str();
+            facilities::formatting::StringBuilder<> builder;
+            builder << '{' << sink.toString() << ',' << writer.toString() << '}';
+            return builder.str();
         }
 
       private:
@@ -342,11 +343,12 @@ namespace hlibs::logging {
         {
             using facilities::timestamp::DateTime;
             DateTime dt{};
-            auto filename = "file_logger_" + dt.filestamp() + ".log";
+            facilities::formatting::StringBuilder<64> filename;
+            filename << "file_logger_" << dt.filestamp() << ".log";
 
             if (base.has_filename()) throw std::invalid_argument("base.has_filename()");
             auto filepath = std::filesystem::path(base);
-            filepath.append(filename);
+            filepath.append(filename.view());
             return filepath.string();
         }
 
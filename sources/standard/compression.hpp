@@ -0,0 +1,440 @@
+#ifndef LIBS_COMPRESSION_HPP
+#define LIBS_COMPRESSION_HPP
+
+#include <streambuf>
+#include <istream>
+#include <iostream>
+#include <vector>
+#include <array>
+#include <span>
+#include <string>
+#include <string_view>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+#include <future>
+#include <stdexcept>
+
+
+namespace hlibs::standard::compression {
+
+    /// Upper bound of Block::Compress() output for n input bytes.
+    [[maybe_unused]] static constexpr std::size_t CompressBound(std::size_t n) noexcept
+    {
+        return n + n / 255 + 16;
+    }
+
+    /// LZ77 block codec in the layout of LZ4 blocks: sequences of a token (literal length : match length - 4),
+    /// length extensions of 255-valued bytes, literals, and a 16-bit little-endian offset into the last 64 KiB.
+    /// Matching is greedy over a single-slot hash table (the last position of every hash), without chains.
+    /// url:https://github.com/lz4/lz4/blob/dev/doc/lz4_Block_format.md
+    struct Block {
+        static constexpr std::size_t min_match = 4;
+        static constexpr std::size_t last_literals = 5;
+        static constexpr std::size_t match_limit = 12;
+        static constexpr std::size_t max_offset = 65535;
+        static constexpr int hash_log = 14;
+
+        /// Returns the compressed size, or 0 if the output does not fit in out.
+        static std::size_t Compress(std::span<const char> in, std::span<char> out) noexcept
+        {
+            const auto* src = reinterpret_cast<const unsigned char*>(in.data());
+            auto* dst = reinterpret_cast<unsigned char*>(out.data());
+            const std::size_t n = in.size();
+            const std::size_t capacity = out.size();
+            std::size_t op = 0;
+            std::size_t anchor = 0;
+
+            if (n > match_limit) {
+                std::array<std::uint32_t, 1U << hash_log> table{};
+                const std::size_t limit = n - match_limit;
+                const std::size_t match_end = n - last_literals;
+                std::size_t ip = 1;
+                table[Hash(Read32(src))] = 0;
+
+                while (ip < limit) {
+                    auto sequence = Read32(src + ip);
+                    auto& slot = table[Hash(sequence)];
+                    std::size_t candidate = slot;
+                    slot = static_cast<std::uint32_t>(ip);
+
+                    if (ip - candidate > max_offset || Read32(src + candidate) != sequence) {
+                        ip += 1 + ((ip - anchor) >> 6);
+                        continue;
+                    }
+
+                    while (ip > anchor && candidate > 0 && src[ip - 1] == src[candidate - 1]) {
+                        --ip;
+                        --candidate;
+                    }
+
+                    std::size_t length = min_match;
+                    while (ip + length < match_end && src[ip + length] == src[candidate + length]) ++length;
+
+                    if (!Sequence(dst, capacity, op, src + anchor, ip - anchor, ip - candidate, length)) return 0;
+                    ip += length;
+                    anchor = ip;
+                    if (ip < limit) table[Hash(Read32(src + ip - 2))] = static_cast<std::uint32_t>(ip - 2);
+                }
+            }
+
+            if (!Sequence(dst, capacity, op, src + anchor, n - anchor, 0, 0)) return 0;
+            return op;
+        }
+
+        /// Returns the decompressed size; malformed input (out of bounds lengths or offsets) throws.
+        static std::size_t Decompress(std::span<const char> in, std::span<char> out)
+        {
+            const auto* src = reinterpret_cast<const unsigned char*>(in.data());
+            auto* dst = reinterpret_cast<unsigned char*>(out.data());
+            const std::size_t n = in.size();
+            const std::size_t capacity = out.size();
+            std::size_t ip = 0;
+            std::size_t op = 0;
+
+            while (ip < n) {
+                const unsigned token = src[ip++];
+                std::size_t literals = Length(src, n, ip, token >> 4);
+                if (literals > n - ip || literals > capacity - op) throw std::invalid_argument("literals out of bounds");
+                std::memcpy(dst + op, src + ip, literals);
+                ip += literals;
+                op += literals;
+
+                if (ip == n) break;
+                if (n - ip < 2) throw std::invalid_argument("offset out of bounds");
+                std::size_t offset = src[ip] | (static_cast<std::size_t>(src[ip + 1]) << 8);
+                ip += 2;
+                if (offset == 0 || offset > op) throw std::invalid_argument("offset out of window");
+
+                std::size_t length = Length(src, n, ip, token & 15U) + min_match;
+                if (length > capacity - op) throw std::invalid_argument("match out of bounds");
+
+                if (offset >= length) {
+                    std::memcpy(dst + op, dst + op - offset, length);
+                }
+                else {
+                    // overlapping match: the pattern repeats every offset bytes, so copy it period by period
+                    for (std::size_t done = 0; done < length; done += offset) {
+                        std::memcpy(dst + op + done, dst + op - offset + done, std::min(offset, length - done));
+                    }
+                }
+
+                op += length;
+            }
+
+            return op;
+        }
+
+      private:
+        static std::uint32_t Read32(const unsigned char* p) noexcept
+        {
+            std::uint32_t value;
+            std::memcpy(&value, p, sizeof(value));
+            return value;
+        }
+
+        static std::size_t Hash(std::uint32_t sequence) noexcept
+        {
+            return (sequence * 2654435761U) >> (32 - hash_log);
+        }
+
+        static std::size_t Length(const unsigned char* src, std::size_t n, std::size_t& ip, unsigned nibble)
+        {
+            std::size_t length = nibble;
+            if (nibble != 15) return length;
+
+            unsigned char extension;
+
+            do {
+                if (ip == n) throw std::invalid_argument("length out of bounds");
+                extension = src[ip++];
+                length += extension;
+            } while (extension == 255);
+
+            return length;
+        }
+
+        static bool Extend(unsigned char* dst, std::size_t capacity, std::size_t& op, std::size_t rest) noexcept
+        {
+            for (; rest >= 255; rest -= 255) {
+                if (op == capacity) return false;
+                dst[op++] = 255;
+            }
+
+            if (op == capacity) return false;
+            dst[op++] = static_cast<unsigned char>(rest);
+            return true;
+        }
+
+        /// Emits literals followed by a match; a zero length match ends the block.
+        static bool Sequence(unsigned char* dst, std::size_t capacity, std::size_t& op, const unsigned char* literals, std::size_t count,
+                             std::size_t offset, std::size_t length) noexcept
+        {
+            if (op == capacity) return false;
+            std::size_t token = op++;
+            auto literal_nibble = static_cast<unsigned>(std::min<std::size_t>(count, 15));
+            dst[token] = static_cast<unsigned char>(literal_nibble << 4);
+            if (count >= 15 && !Extend(dst, capacity, op, count - 15)) return false;
+            if (capacity - op < count) return false;
+            std::memcpy(dst + op, literals, count);
+            op += count;
+
+            if (length == 0) return true;
+            if (capacity - op < 2) return false;
+            dst[op++] = static_cast<unsigned char>(offset & 0xFF);
+            dst[op++] = static_cast<unsigned char>(offset >> 8);
+
+            auto match_nibble = static_cast<unsigned>(std::min<std::size_t>(length - min_match, 15));
+            dst[token] = static_cast<unsigned char>(dst[token] | match_nibble);
+            return length - min_match < 15 || Extend(dst, capacity, op, length - min_match - 15);
+        }
+    };
+
+
+    /// The frame: "HLZ1", the block size (u32), then blocks of [stored size (u32, top bit set if kept raw),
+    /// raw size (u32), payload], and a zero u32 as the end mark. Frames may be concatenated.
+    struct Frame {
+        static constexpr std::string_view magic = "HLZ1";
+        static constexpr std::uint32_t raw_flag = 0x80000000U;
+        static constexpr std::size_t max_block_size = 1UL << 28;
+
+        std::size_t block_size = 1UL << 20;
+        std::size_t threads = 1;    ///< blocks compressed at once (each on its own thread)
+
+        /// Whether the stream starts with a frame; the read position is restored.
+        static bool IsFramed(std::istream& stream)
+        {
+            std::array<char, 4> head{};
+            auto start = stream.tellg();
+            stream.read(head.data(), head.size());
+            bool isFramed = stream.gcount() == 4 && std::string_view(head.data(), head.size()) == magic;
+            stream.clear();
+            stream.seekg(start);
+            return isFramed;
+        }
+
+        static void Put32(std::streambuf& target, std::uint32_t value)
+        {
+            std::array<char, 4> bytes{};
+            for (std::size_t i = 0; i != bytes.size(); ++i) bytes[i] = static_cast<char>((value >> (8 * i)) & 0xFFU);
+            if (target.sputn(bytes.data(), 4) != 4) throw std::ios_base::failure("sputn() != 4");
+        }
+
+        /// False at a clean end of the source.
+        static bool Get32(std::streambuf& source, std::uint32_t& value)
+        {
+            std::array<unsigned char, 4> bytes{};
+            auto n = source.sgetn(reinterpret_cast<char*>(bytes.data()), 4);
+            if (n == 0) return false;
+            if (n != 4) throw std::ios_base::failure("truncated frame");
+            value = bytes[0] | (bytes[1] << 8U) | (bytes[2] << 16U) | (static_cast<std::uint32_t>(bytes[3]) << 24U);
+            return true;
+        }
+    };
+
+
+    /// Output filter compressing everything written into frames for the target buffer; the frame is ended on destruction.
+    class CompressingBuffer final : public std::streambuf {
+      public:
+        CompressingBuffer(std::streambuf* destination, Frame options = {})
+                : target(destination), frame(options), pending(std::clamp<std::size_t>(options.block_size, 64, Frame::max_block_size) * std::max<std::size_t>(options.threads, 1))
+        {
+            frame.block_size = std::clamp<std::size_t>(frame.block_size, 64, Frame::max_block_size);
+            frame.threads = std::max<std::size_t>(frame.threads, 1);
+            if (target->sputn(Frame::magic.data(), 4) != 4) throw std::ios_base::failure("sputn() != 4");
+            Frame::Put32(*target, static_cast<std::uint32_t>(frame.block_size));
+            setp(pending.data(), pending.data() + pending.size());
+        }
+
+        CompressingBuffer(const CompressingBuffer& rhs) = delete;
+        CompressingBuffer& operator=(const CompressingBuffer& rhs) = delete;
+
+        ~CompressingBuffer() noexcept override
+        {
+            try {
+                finish();
+            }
+            catch (const std::exception& e) {
+                std::cerr << "~CompressingBuffer->exception: " << e.what();
+            }
+        }
+
+        /// Writes the pending blocks and the end mark; later writes start a new frame.
+        void finish()
+        {
+            if (finished) return;
+            drain();
+            Frame::Put32(*target, 0);
+            target->pubsync();
+            finished = true;
+        }
+
+        inline std::size_t consumed() const noexcept
+        {
+            return raw_bytes + static_cast<std::size_t>(pptr() - pbase());
+        }
+
+        inline std::size_t produced() const noexcept
+        {
+            return stored_bytes;
+        }
+
+      protected:
+        int_type overflow(int_type ch) override
+        {
+            drain();
+            if (traits_type::eq_int_type(ch, traits_type::eof())) return traits_type::not_eof(ch);
+            *pptr() = traits_type::to_char_type(ch);
+            pbump(1);
+            return ch;
+        }
+
+        int sync() override
+        {
+            drain();
+            return target->pubsync();
+        }
+
+      private:
+        /// Compresses the pending bytes block by block (in parallel when allowed) and writes them in order.
+        void drain()
+        {
+            if (finished) {
+                if (target->sputn(Frame::magic.data(), 4) != 4) throw std::ios_base::failure("sputn() != 4");
+                Frame::Put32(*target, static_cast<std::uint32_t>(frame.block_size));
+                finished = false;
+            }
+
+            std::span<const char> data(pbase(), static_cast<std::size_t>(pptr() - pbase()));
+            std::vector<std::span<const char>> blocks;
+
+            for (std::size_t offset = 0; offset < data.size(); offset += frame.block_size) {
+                blocks.push_back(data.subspan(offset, std::min(frame.block_size, data.size() - offset)));
+            }
+
+            outputs.resize(blocks.size());
+            std::vector<std::size_t> sizes(blocks.size());
+            std::vector<std::future<void>> tasks;
+
+            for (std::size_t i = 0; i != blocks.size(); ++i) {
+                auto job = [this, &blocks, &sizes, i] {
+                    outputs[i].resize(CompressBound(blocks[i].size()));
+                    sizes[i] = Block::Compress(blocks[i], outputs[i]);
+                };
+
+                if (i + 1 == blocks.size()) {
+                    job();
+                }
+                else {
+                    tasks.push_back(std::async(std::launch::async, job));
+                }
+            }
+
+            for (auto& task : tasks) task.get();
+
+            for (std::size_t i = 0; i != blocks.size(); ++i) {
+                bool isStoredRaw = sizes[i] == 0 || sizes[i] >= blocks[i].size();
+                auto stored = isStoredRaw ? blocks[i] : std::span<const char>(outputs[i].data(), sizes[i]);
+                Frame::Put32(*target, static_cast<std::uint32_t>(stored.size()) | (isStoredRaw ? Frame::raw_flag : 0U));
+                Frame::Put32(*target, static_cast<std::uint32_t>(blocks[i].size()));
+                auto size = static_cast<std::streamsize>(stored.size());
+                if (target->sputn(stored.data(), size) != size) throw std::ios_base::failure("sputn() != size");
+                raw_bytes += blocks[i].size();
+                stored_bytes += stored.size() + 8;
+            }
+
+            setp(pending.data(), pending.data() + pending.size());
+        }
+
+        std::streambuf* target;
+        Frame frame;
+        std::vector<char> pending;
+        std::vector<std::vector<char>> outputs{};
+        std::size_t raw_bytes = 0;
+        std::size_t stored_bytes = 0;
+        bool finished = false;
+    };
+
+
+    /// Input filter decompressing the frames read from the source buffer. Sizes in the headers are checked against the
+    /// block size of the frame before anything is allocated; corrupted data throws from underflow().
+    class DecompressingBuffer final : public std::streambuf {
+      public:
+        explicit DecompressingBuffer(std::streambuf* origin): source(origin)
+        {
+            if (!header()) throw std::ios_base::failure("!isFramed");
+        }
+
+        DecompressingBuffer(const DecompressingBuffer& rhs) = delete;
+        DecompressingBuffer& operator=(const DecompressingBuffer& rhs) = delete;
+
+        ~DecompressingBuffer() noexcept override = default;
+
+      protected:
+        int_type underflow() override
+        {
+            while (gptr() == egptr()) {
+                if (ended || !next()) {
+                    ended = true;
+                    return traits_type::eof();
+                }
+            }
+
+            return traits_type::to_int_type(*gptr());
+        }
+
+      private:
+        bool header()
+        {
+            std::array<char, 4> magic{};
+            if (source->sgetn(magic.data(), 4) != 4 || std::string_view(magic.data(), 4) != Frame::magic) return false;
+            std::uint32_t size = 0;
+            if (!Frame::Get32(*source, size)) throw std::ios_base::failure("truncated frame");
+            if (size == 0 || size > Frame::max_block_size) throw std::invalid_argument("block_size out of range");
+            block_size = size;
+            return true;
+        }
+
+        /// Loads the next block (or the first block of a concatenated frame); false at the end.
+        bool next()
+        {
+            std::uint32_t stored = 0;
+            std::uint32_t raw = 0;
+
+            if (!Frame::Get32(*source, stored)) throw std::ios_base::failure("missing end mark");
+
+            if (stored == 0) {
+                if (traits_type::eq_int_type(source->sgetc(), traits_type::eof())) return false;
+                if (!header()) throw std::ios_base::failure("!isFramed");
+                return true;
+            }
+
+            if (!Frame::Get32(*source, raw)) throw std::ios_base::failure("truncated frame");
+            auto size = stored & ~Frame::raw_flag;
+            if (raw > block_size) throw std::invalid_argument("raw > block_size");
+            if (size > CompressBound(block_size)) throw std::invalid_argument("size > CompressBound(block_size)");
+            block.resize(raw);
+
+            if (stored & Frame::raw_flag) {
+                if (size != raw || source->sgetn(block.data(), size) != size) throw std::ios_base::failure("truncated frame");
+            }
+            else {
+                payload.resize(size);
+                if (source->sgetn(payload.data(), size) != size) throw std::ios_base::failure("truncated frame");
+                if (Block::Decompress(payload, block) != raw) throw std::invalid_argument("raw size mismatch");
+            }
+
+            setg(block.data(), block.data(), block.data() + block.size());
+            return true;
+        }
+
+        std::streambuf* source;
+        std::size_t block_size = 0;
+        bool ended = false;
+        std::vector<char> payload{};
+        std::vector<char> block{};
+    };
+
+}
+
+#endif //LIBS_COMPRESSION_HPP
@@ -0,0 +1,494 @@
+#ifndef LIBS_UTF8_HPP
+#define LIBS_UTF8_HPP
+
+#include <string>
+#include <string_view>
+#include <vector>
+#include <span>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <utility>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+
+namespace hlibs::standard::utf8 {
+
+    /// Error bits of the lookup validation; a byte pair is wrong when all three lookups agree on one.
+    /// url:https://arxiv.org/abs/2010.03090
+    struct Lookup {
+        static constexpr std::uint8_t too_short = 1U << 0;
+        static constexpr std::uint8_t too_long = 1U << 1;
+        static constexpr std::uint8_t overlong_3 = 1U << 2;
+        static constexpr std::uint8_t too_large = 1U << 3;
+        static constexpr std::uint8_t surrogate = 1U << 4;
+        static constexpr std::uint8_t overlong_2 = 1U << 5;
+        static constexpr std::uint8_t too_large_1000 = 1U << 6;
+        static constexpr std::uint8_t overlong_4 = 1U << 6;
+        static constexpr std::uint8_t two_conts = 1U << 7;
+        static constexpr std::uint8_t carry = too_short | too_long | two_conts;
+
+        /// By the high nibble of the previous byte.
+        static constexpr std::array<std::uint8_t, 16> byte_1_high = {
+                too_long, too_long, too_long, too_long, too_long, too_long, too_long, too_long,
+                two_conts, two_conts, two_conts, two_conts,
+                too_short | overlong_2,
+                too_short,
+                too_short | overlong_3 | surrogate,
+                too_short | too_large | too_large_1000 | overlong_4
+        };
+
+        /// By the low nibble of the previous byte.
+        static constexpr std::array<std::uint8_t, 16> byte_1_low = {
+                carry | overlong_3 | overlong_2 | overlong_4,
+                carry | overlong_2,
+                carry,
+                carry,
+                carry | too_large,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000 | surrogate,
+                carry | too_large | too_large_1000,
+                carry | too_large | too_large_1000
+        };
+
+        /// By the high nibble of the current byte.
+        static constexpr std::array<std::uint8_t, 16> byte_2_high = {
+                too_short, too_short, too_short, too_short, too_short, too_short, too_short, too_short,
+                too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 | overlong_4,
+                too_long | overlong_2 | two_conts | overlong_3 | too_large,
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                too_long | overlong_2 | two_conts | surrogate | too_large,
+                too_short, too_short, too_short, too_short
+        };
+    };
+
+
+    /// Byte by byte reference validation; the position of the first byte of the first malformed sequence, or npos.
+    [[maybe_unused]] static std::size_t FindInvalidScalar(std::string_view text, std::size_t from = 0) noexcept
+    {
+        const auto* s = reinterpret_cast<const unsigned char*>(text.data());
+        const std::size_t n = text.size();
+        std::size_t i = from;
+
+        while (i < n) {
+            if (n - i >= 8) {
+                std::uint64_t word;
+                std::memcpy(&word, s + i, 8);
+
+                if ((word & 0x8080808080808080ULL) == 0) {
+                    i += 8;
+                    continue;
+                }
+            }
+
+            const unsigned lead = s[i];
+
+            if (lead < 0x80) {
+                ++i;
+                continue;
+            }
+
+            std::size_t length;
+            char32_t point;
+
+            if (lead >= 0xC2 && lead <= 0xDF) {
+                length = 2;
+                point = lead & 0x1FU;
+            }
+            else if ((lead & 0xF0U) == 0xE0) {
+                length = 3;
+                point = lead & 0x0FU;
+            }
+            else if (lead >= 0xF0 && lead <= 0xF4) {
+                length = 4;
+                point = lead & 0x07U;
+            }
+            else {
+                return i;
+            }
+
+            if (n - i < length) return i;
+
+            for (std::size_t k = 1; k != length; ++k) {
+                if ((s[i + k] & 0xC0U) != 0x80) return i;
+                point = (point << 6) | (s[i + k] & 0x3FU);
+            }
+
+            bool isOverlong = (length == 3 && point < 0x800) || (length == 4 && point < 0x10000);
+            bool isSurrogate = point >= 0xD800 && point <= 0xDFFF;
+            if (isOverlong || isSurrogate || point > 0x10FFFF) return i;
+            i += length;
+        }
+
+        return std::string_view::npos;
+    }
+
+
+#if defined(__x86_64__)
+    /// Offset of the first 16-byte block in which an error shows up (or of the last one for a truncated end), or npos.
+    __attribute__((target("ssse3"))) static std::size_t FirstInvalidBlockSSSE3(const char* data, std::size_t size) noexcept
+    {
+        const auto table = [](const std::array<std::uint8_t, 16>& values) {
+            return _mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data()));
+        };
+
+        const __m128i byte_1_high = table(Lookup::byte_1_high);
+        const __m128i byte_1_low = table(Lookup::byte_1_low);
+        const __m128i byte_2_high = table(Lookup::byte_2_high);
+        const __m128i nibble = _mm_set1_epi8(0x0F);
+        const __m128i max_tail = _mm_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xEF), char(0xDF), char(0xBF));
+        const __m128i zero = _mm_setzero_si128();
+        __m128i prev_input = zero;
+        __m128i prev_incomplete = zero;
+        std::size_t offset = 0;
+
+        for (; offset < size; offset += 16) {
+            __m128i input;
+
+            if (size - offset >= 16) {
+                input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(data + offset));
+            }
+            else {
+                std::array<char, 16> tail{};
+                std::memcpy(tail.data(), data + offset, size - offset);
+                input = _mm_loadu_si128(reinterpret_cast<const __m128i*>(tail.data()));
+            }
+
+            __m128i error = prev_incomplete;
+
+            if (_mm_movemask_epi8(input) != 0) {
+                __m128i prev1 = _mm_alignr_epi8(input, prev_input, 15);
+                __m128i special = _mm_and_si128(_mm_and_si128(_mm_shuffle_epi8(byte_1_high, _mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)),
+                                                              _mm_shuffle_epi8(byte_1_low, _mm_and_si128(prev1, nibble))),
+                                                _mm_shuffle_epi8(byte_2_high, _mm_and_si128(_mm_srli_epi16(input, 4), nibble)));
+                __m128i third = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 14), _mm_set1_epi8(0xE0 - 0x80));
+                __m128i fourth = _mm_subs_epu8(_mm_alignr_epi8(input, prev_input, 13), _mm_set1_epi8(0xF0 - 0x80));
+                __m128i must23 = _mm_and_si128(_mm_or_si128(third, fourth), _mm_set1_epi8(char(0x80)));
+                error = _mm_xor_si128(must23, special);
+                prev_incomplete = _mm_subs_epu8(input, max_tail);
+            }
+
+            if (_mm_movemask_epi8(_mm_cmpeq_epi8(error, zero)) != 0xFFFF) return offset;
+            prev_input = input;
+        }
+
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(prev_incomplete, zero)) != 0xFFFF) return offset - 16;
+        return std::string_view::npos;
+    }
+
+    __attribute__((target("avx2"))) static __m256i TableAVX2(const std::array<std::uint8_t, 16>& values) noexcept
+    {
+        return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(values.data())));
+    }
+
+    /// The bytes shifted by N positions across the two 128-bit lanes, taking the first ones from the previous block.
+    template<int N>
+    __attribute__((target("avx2"))) static __m256i PreviousAVX2(__m256i input, __m256i prev_input) noexcept
+    {
+        return _mm256_alignr_epi8(input, _mm256_permute2x128_si256(prev_input, input, 0x21), 16 - N);
+    }
+
+    /// The same as FirstInvalidBlockSSSE3() with 32-byte blocks.
+    __attribute__((target("avx2"))) static std::size_t FirstInvalidBlockAVX2(const char* data, std::size_t size) noexcept
+    {
+        const __m256i byte_1_high = TableAVX2(Lookup::byte_1_high);
+        const __m256i byte_1_low = TableAVX2(Lookup::byte_1_low);
+        const __m256i byte_2_high = TableAVX2(Lookup::byte_2_high);
+        const __m256i nibble = _mm256_set1_epi8(0x0F);
+        const __m256i max_tail = _mm256_setr_epi8(-1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+                                                  -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, char(0xEF), char(0xDF), char(0xBF));
+        __m256i prev_input = _mm256_setzero_si256();
+        __m256i prev_incomplete = _mm256_setzero_si256();
+        std::size_t offset = 0;
+
+        for (; offset < size; offset += 32) {
+            __m256i input;
+
+            if (size - offset >= 32) {
+                input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(data + offset));
+            }
+            else {
+                std::array<char, 32> tail{};
+                std::memcpy(tail.data(), data + offset, size - offset);
+                input = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(tail.data()));
+            }
+
+            __m256i error = prev_incomplete;
+
+            if (_mm256_movemask_epi8(input) != 0) {
+                __m256i prev1 = PreviousAVX2<1>(input, prev_input);
+                __m256i special = _mm256_and_si256(
+                        _mm256_and_si256(_mm256_shuffle_epi8(byte_1_high, _mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)),
+                                         _mm256_shuffle_epi8(byte_1_low, _mm256_and_si256(prev1, nibble))),
+                        _mm256_shuffle_epi8(byte_2_high, _mm256_and_si256(_mm256_srli_epi16(input, 4), nibble)));
+                __m256i third = _mm256_subs_epu8(PreviousAVX2<2>(input, prev_input), _mm256_set1_epi8(0xE0 - 0x80));
+                __m256i fourth = _mm256_subs_epu8(PreviousAVX2<3>(input, prev_input), _mm256_set1_epi8(0xF0 - 0x80));
+                __m256i must23 = _mm256_and_si256(_mm256_or_si256(third, fourth), _mm256_set1_epi8(char(0x80)));
+                error = _mm256_xor_si256(must23, special);
+                prev_incomplete = _mm256_subs_epu8(input, max_tail);
+            }
+
+            if (!_mm256_testz_si256(error, error)) return offset;
+            prev_input = input;
+        }
+
+        if (!_mm256_testz_si256(prev_incomplete, prev_incomplete)) return offset - 32;
+        return std::string_view::npos;
+    }
+#endif
+
+
+    /// Position of the first byte of the first malformed sequence (truncated, overlong, surrogate, beyond U+10FFFF), or npos.
+    /// Blocks are checked with AVX2 or SSSE3 lookups when the CPU has them; the scalar check only pinpoints the error.
+    [[maybe_unused]] static std::size_t FindInvalid(std::string_view text) noexcept
+    {
+#if defined(__x86_64__)
+        static const bool hasAVX2 = __builtin_cpu_supports("avx2");
+        static const bool hasSSSE3 = __builtin_cpu_supports("ssse3");
+
+        if (hasAVX2 || hasSSSE3) {
+            auto block = hasAVX2 ? FirstInvalidBlockAVX2(text.data(), text.size()) : FirstInvalidBlockSSSE3(text.data(), text.size());
+            if (block == std::string_view::npos) return block;
+
+            std::size_t from = block >= 3 ? block - 3 : 0;
+            while (from > 0 && (static_cast<unsigned char>(text[from]) & 0xC0U) == 0x80) --from;
+            return FindInvalidScalar(text, from);
+        }
+#endif
+        return FindInvalidScalar(text);
+    }
+
+    [[maybe_unused]] static std::size_t FindInvalid(const std::vector<char>& data) noexcept
+    {
+        return FindInvalid(std::string_view(data.data(), data.size()));
+    }
+
+    [[maybe_unused]] static bool IsValid(std::string_view text) noexcept
+    {
+        return FindInvalid(text) == std::string_view::npos;
+    }
+
+    /// E.g. IsValid(loader.data()) right after FileLoader::read().
+    [[maybe_unused]] static bool IsValid(const std::vector<char>& data) noexcept
+    {
+        return IsValid(std::string_view(data.data(), data.size()));
+    }
+
+
+    /// Counts the bytes that are not continuation bytes (10xxxxxx), and those starting four-byte sequences.
+    [[maybe_unused]] static std::pair<std::size_t, std::size_t> CountLeads(std::string_view text) noexcept
+    {
+        std::size_t leads = 0;
+        std::size_t quads = 0;
+        std::size_t i = 0;
+
+#if defined(__SSE2__)
+        const __m128i continuation_max = _mm_set1_epi8(-65);    // 0xBF
+        const __m128i quad_min = _mm_set1_epi8(-17);            // 0xEF, as signed
+
+        for (; i + 16 <= text.size(); i += 16) {
+            __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text.data() + i));
+            leads += static_cast<std::size_t>(__builtin_popcount(_mm_movemask_epi8(_mm_cmpgt_epi8(bytes, continuation_max))));
+            __m128i isQuad = _mm_and_si128(_mm_cmpgt_epi8(bytes, quad_min), _mm_cmplt_epi8(bytes, _mm_setzero_si128()));
+            quads += static_cast<std::size_t>(__builtin_popcount(_mm_movemask_epi8(isQuad)));
+        }
+#endif
+
+        for (; i != text.size(); ++i) {
+            auto byte = static_cast<signed char>(text[i]);
+            leads += byte > -65;
+            quads += byte > -17 && byte < 0;
+        }
+
+        return {leads, quads};
+    }
+
+    /// The number of code points of valid UTF-8 text (and the UTF-32 length).
+    [[maybe_unused]] static std::size_t CountCodePoints(std::string_view text) noexcept
+    {
+        return CountLeads(text).first;
+    }
+
+    [[maybe_unused]] static std::size_t CountCodePoints(const std::vector<char>& data) noexcept
+    {
+        return CountCodePoints(std::string_view(data.data(), data.size()));
+    }
+
+    /// The number of UTF-16 code units for valid UTF-8 text.
+    [[maybe_unused]] static std::size_t UTF16Length(std::string_view text) noexcept
+    {
+        auto [leads, quads] = CountLeads(text);
+        return leads + quads;
+    }
+
+
+    /// Writes the code point as 1 to 4 bytes; returns their number (0 for surrogates and values beyond U+10FFFF).
+    [[maybe_unused]] static std::size_t Encode(char32_t point, char* out) noexcept
+    {
+        if (point < 0x80) {
+            out[0] = static_cast<char>(point);
+            return 1;
+        }
+
+        if (point < 0x800) {
+            out[0] = static_cast<char>(0xC0 | (point >> 6));
+            out[1] = static_cast<char>(0x80 | (point & 0x3F));
+            return 2;
+        }
+
+        if (point >= 0xD800 && point <= 0xDFFF) return 0;
+
+        if (point < 0x10000) {
+            out[0] = static_cast<char>(0xE0 | (point >> 12));
+            out[1] = static_cast<char>(0x80 | ((point >> 6) & 0x3F));
+            out[2] = static_cast<char>(0x80 | (point & 0x3F));
+            return 3;
+        }
+
+        if (point > 0x10FFFF) return 0;
+        out[0] = static_cast<char>(0xF0 | (point >> 18));
+        out[1] = static_cast<char>(0x80 | ((point >> 12) & 0x3F));
+        out[2] = static_cast<char>(0x80 | ((point >> 6) & 0x3F));
+        out[3] = static_cast<char>(0x80 | (point & 0x3F));
+        return 4;
+    }
+
+    /// Decodes valid UTF-8 into the target (of at least CountCodePoints() elements); returns the number of code points.
+    /// Malformed text throws before anything is written.
+    [[maybe_unused]] static std::size_t ToUTF32(std::string_view text, std::span<char32_t> target)
+    {
+        if (!IsValid(text)) throw std::invalid_argument("!IsValid(text)");
+        if (target.size() < CountCodePoints(text)) throw std::length_error("target.size() < CountCodePoints(text)");
+
+        const auto* s = reinterpret_cast<const unsigned char*>(text.data());
+        const std::size_t n = text.size();
+        std::size_t i = 0;
+        std::size_t o = 0;
+
+        while (i < n) {
+#if defined(__SSE2__)
+            if (n - i >= 16) {
+                __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i));
+
+                if (_mm_movemask_epi8(bytes) == 0) {
+                    const __m128i zero = _mm_setzero_si128();
+                    __m128i low = _mm_unpacklo_epi8(bytes, zero);
+                    __m128i high = _mm_unpackhi_epi8(bytes, zero);
+                    auto* out = reinterpret_cast<__m128i*>(target.data() + o);
+                    _mm_storeu_si128(out, _mm_unpacklo_epi16(low, zero));
+                    _mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+                    _mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+                    _mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+                    i += 16;
+                    o += 16;
+                    continue;
+                }
+            }
+#endif
+            const unsigned lead = s[i];
+
+            if (lead < 0x80) {
+                target[o++] = lead;
+                ++i;
+            }
+            else if (lead < 0xE0) {
+                target[o++] = ((lead & 0x1FU) << 6) | (s[i + 1] & 0x3FU);
+                i += 2;
+            }
+            else if (lead < 0xF0) {
+                target[o++] = ((lead & 0x0FU) << 12) | ((s[i + 1] & 0x3FU) << 6) | (s[i + 2] & 0x3FU);
+                i += 3;
+            }
+            else {
+                target[o++] = ((lead & 0x07U) << 18) | ((s[i + 1] & 0x3FU) << 12) | ((s[i + 2] & 0x3FU) << 6) | (s[i + 3] & 0x3FU);
+                i += 4;
+            }
+        }
+
+        return o;
+    }
+
+    [[maybe_unused]] static std::u32string ToUTF32(std::string_view text)
+    {
+        std::u32string result(CountCodePoints(text), U'\0');
+        result.resize(ToUTF32(text, result));
+        return result;
+    }
+
+    [[maybe_unused]] static std::u32string ToUTF32(const std::vector<char>& data)
+    {
+        return ToUTF32(std::string_view(data.data(), data.size()));
+    }
+
+    /// Code points above U+FFFF become surrogate pairs.
+    [[maybe_unused]] static std::u16string ToUTF16(std::string_view text)
+    {
+        auto points = ToUTF32(text);
+        std::u16string result;
+        result.reserve(UTF16Length(text));
+
+        for (char32_t point : points) {
+            if (point < 0x10000) {
+                result.push_back(static_cast<char16_t>(point));
+                continue;
+            }
+
+            point -= 0x10000;
+            result.push_back(static_cast<char16_t>(0xD800 + (point >> 10)));
+            result.push_back(static_cast<char16_t>(0xDC00 + (point & 0x3FF)));
+        }
+
+        return result;
+    }
+
+    [[maybe_unused]] static std::string FromUTF32(std::u32string_view points)
+    {
+        std::string result(points.size() * 4, '\0');
+        std::size_t o = 0;
+
+        for (char32_t point : points) {
+            auto length = Encode(point, result.data() + o);
+            if (length == 0) throw std::invalid_argument("!isScalarValue(point)");
+            o += length;
+        }
+
+        result.resize(o);
+        return result;
+    }
+
+    /// Unpaired surrogates throw.
+    [[maybe_unused]] static std::string FromUTF16(std::u16string_view units)
+    {
+        std::string result(units.size() * 3, '\0');
+        std::size_t o = 0;
+
+        for (std::size_t i = 0; i != units.size(); ++i) {
+            char32_t point = units[i];
+
+            if (point >= 0xD800 && point <= 0xDBFF && i + 1 != units.size() && units[i + 1] >= 0xDC00 && units[i + 1] <= 0xDFFF) {
+                point = 0x10000 + ((point - 0xD800) << 10) + (units[++i] - 0xDC00);
+            }
+
+            auto length = Encode(point, result.data() + o);
+            if (length == 0) throw std::invalid_argument("unpaired surrogate");
+            o += length;
+        }
+
+        result.resize(o);
+        return result;
+    }
+
+}
+
+#endif //LIBS_UTF8_HPP
@@ -0,0 +1,93 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <string>
+#include <vector>
+
+#include "../../sources/facilities/base64.hpp"
+#include "../../sources/io/helper_objects.hpp"
+
+
+TEST_CASE("Base64", "[libs][facilities][base64]")
+{
+    using namespace hlibs::facilities::base64;
+
+    SECTION("RFC 4648 test vectors → expected, both ways", "[basic_check]") {
+        const std::vector<std::pair<std::string, std::string>> vectors = {
+                {"", ""}, {"f", "Zg=="}, {"fo", "Zm8="}, {"foo", "Zm9v"}, {"foob", "Zm9vYg=="}, {"fooba", "Zm9vYmE="}, {"foobar", "Zm9vYmFy"}
+        };
+
+        for (const auto& [bytes, text] : vectors) {
+            REQUIRE(Encode(bytes) == text);
+            REQUIRE(Decode(text) == bytes);
+            REQUIRE(EncodedSize(bytes.size()) == text.size());
+            REQUIRE(DecodedSize(text) == bytes.size());
+        }
+    }
+
+    SECTION("URL-safe alphabet, no padding → '-' and '_', round trip", "[functional_requirements]") {
+        const std::string bytes = "\xFB\xFF\xBF subjects?_d=1 \xFB\xFF\xBF and more than sixteen bytes \xFF\xFE";
+
+        auto standard = Encode(bytes);
+        auto url = Encode(bytes, Alphabet::URL, false);
+
+        REQUIRE_THAT(standard, Catch::Matchers::StartsWith("+/+/"));
+        REQUIRE_THAT(url, Catch::Matchers::StartsWith("-_-_"));
+        REQUIRE(url.size() == EncodedSize(bytes.size(), false));
+        REQUIRE(url.find('=') == std::string::npos);
+        REQUIRE(Decode(url, Alphabet::URL) == bytes);
+        REQUIRE(Decode(standard) == bytes);
+        REQUIRE_THROWS_AS(Decode(standard, Alphabet::URL), std::invalid_argument);
+    }
+
+    SECTION("characters outside the alphabet, bad length, small target → exception", "[exceptions]") {
+        std::string buffer(2, '\0');
+
+        REQUIRE_THROWS_AS(Decode(std::string(40, 'A') + "\n" + std::string(3, 'A')), std::invalid_argument);
+        REQUIRE_THROWS_AS(Decode("Zm9vY"), std::invalid_argument);
+        REQUIRE_THROWS_AS(Decode("Zm9v", buffer), std::length_error);
+        REQUIRE_THROWS_AS(Encode("foo", buffer), std::length_error);
+    }
+
+    SECTION("encoded line of a file → UTF-8 text, encoded back the same", "[use_case]") {
+        hlibs::io::FileReader reader("../../inputs/get-file-size-2-unicode.txt");
+        const auto line = reader.getNextLine();
+
+        auto text = Decode(line);
+
+        REQUIRE_THAT(text, Catch::Matchers::StartsWith("„Na stronie Centrum Pieniądza NBP"));
+        REQUIRE(Encode(text) == line);
+    }
+
+}
+
+TEST_CASE("Encoder", "[libs][facilities][base64][Encoder]")
+{
+    using hlibs::facilities::base64::Encoder;
+    using hlibs::facilities::base64::Encode;
+    using hlibs::io::FileWriter;
+    using hlibs::io::FileLoader;
+
+    SECTION("pieces of any size into FileWriter → the same as encoding at once", "[use_case]") {
+        const std::filesystem::path path("../../outputs/base64-encoder-1-stream.txt");
+        std::string whole;
+
+        {
+            FileWriter writer(path);
+            Encoder encoder(writer);
+
+            for (int i = 0; i != 3000; ++i) {
+                auto piece = std::string(static_cast<std::size_t>(i % 7), static_cast<char>(i));
+                encoder.update(piece);
+                whole += piece;
+            }
+
+            encoder.finish();
+            REQUIRE(encoder.size() == writer.bytes());
+        }
+
+        FileLoader loader(path);
+        loader.read();
+        REQUIRE(std::string(loader.data().begin(), loader.data().end()) == Encode(whole));
+    }
+
+}
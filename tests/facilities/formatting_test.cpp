@@ -0,0 +1,76 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <sstream>
+#include <iomanip>
+#include <memory_resource>
+#include <cstdint>
+
+#include "../../sources/facilities/formatting.hpp"
+
+
+TEST_CASE("StringBuilder", "[libs][facilities][formatting][StringBuilder]")
+{
+    using hlibs::facilities::formatting::StringBuilder;
+
+    SECTION("text, characters, integers and floats → the same as std::ostream", "[functional_requirements]") {
+        StringBuilder<64> builder;
+        int value = 0;
+
+        builder << "id=" << -42 << ' ' << 0.1 << ' ' << 1e300 << ' ' << 255U << ' ' << std::string("end");
+        builder.append(255, 16).append(' ').append(3.14159, std::chars_format::fixed, 2).appendRepeated('-', 3);
+        builder.append(' ').append(&value);
+
+        std::ostringstream ss;
+        ss << &value;
+        REQUIRE(builder.view() == "id=-42 0.1 1e+300 255 endff 3.14--- " + ss.str());
+        REQUIRE(builder.isInline());
+    }
+
+    SECTION("booleans and signed/unsigned characters → the same as std::ostream", "[functional_requirements]") {
+        StringBuilder<64> builder;
+        const unsigned char letter = 'A';
+        const signed char digit = '7';
+        const std::int8_t sign = '-';
+
+        builder << true << false << ' ' << letter << digit << sign;
+
+        std::ostringstream ss;
+        ss << true << false << ' ' << letter << digit << sign;
+        REQUIRE(builder.view() == ss.str());
+        REQUIRE(builder.view() == "10 A7-");
+    }
+
+    SECTION("quoted text → escaped as std::quoted", "[functional_requirements]") {
+        StringBuilder<16> builder;
+        const std::string text = R"(a "quoted" \path\)";
+
+        builder.appendQuoted(text);
+
+        std::ostringstream ss;
+        ss << std::quoted(text);
+        REQUIRE(builder.view() == ss.str());
+    }
+
+    SECTION("more than the inline capacity → continued in the arena, contents kept", "[memory]") {
+        std::pmr::monotonic_buffer_resource arena;
+        StringBuilder<16> builder(&arena);
+        std::string expected;
+
+        for (int i = 0; i != 1000; ++i) {
+            builder << i << ',';
+            expected += std::to_string(i) + ',';
+        }
+
+        REQUIRE(!builder.isInline());
+        REQUIRE(builder.view() == expected);
+        REQUIRE(builder.capacity() >= expected.size());
+
+        builder.shrink(4);
+        builder.append("!");
+        REQUIRE(builder.str() == expected.substr(0, expected.size() - 4) + '!');
+
+        builder.clear();
+        REQUIRE(builder.view().empty());
+    }
+
+}
@@ -0,0 +1,127 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <random>
+
+#include "../../sources/facilities/hashing.hpp"
+#include "../../sources/io/helper_objects.hpp"
+
+
+TEST_CASE("CRC32C", "[libs][facilities][hashing][CRC32C]")
+{
+    using hlibs::facilities::hashing::CRC32C;
+
+    SECTION("check values → as in the specification", "[basic_check]") {
+        REQUIRE(CRC32C::Of("") == 0x00000000U);
+        REQUIRE(CRC32C::Of("123456789") == 0xE3069283U);
+        REQUIRE(CRC32C::Of(std::string(32, '\0')) == 0x8A9136AAU);
+        REQUIRE(CRC32C::Of(std::string(32, '\xFF')) == 0x62A8AB43U);
+    }
+
+    SECTION("incremental pieces, both paths → the same as at once", "[functional_requirements]") {
+        std::mt19937 engine(11);
+        std::string data(10000, '\0');
+        for (auto& ch : data) ch = static_cast<char>(engine());
+
+        CRC32C crc;
+        for (std::size_t offset = 0, step = 1; offset < data.size(); offset += step, step = step * 3 % 97 + 1) {
+            crc.update(std::string_view(data).substr(offset, step));
+        }
+
+        const auto* bytes = reinterpret_cast<const unsigned char*>(data.data());
+        REQUIRE(crc.value() == CRC32C::Of(data));
+        REQUIRE(~CRC32C::Software(~0U, bytes, data.size()) == CRC32C::Of(data));
+    }
+
+}
+
+TEST_CASE("Hash64", "[libs][facilities][hashing][Hash64]")
+{
+    using hlibs::facilities::hashing::Hash64;
+
+    SECTION("reference values → as XXH64", "[basic_check]") {
+        REQUIRE(Hash64::Of("") == 0xEF46DB3751D8E999ULL);
+        REQUIRE(Hash64::Of("a") == 0xD24EC4F1A98C6E5BULL);
+        REQUIRE(Hash64::Of("abc") == 0x44BC2CF5AD770999ULL);
+        REQUIRE(Hash64::Of("Nobody inspects the spammish repetition") == 0xFBCEA83C8A378BF1ULL);
+    }
+
+    SECTION("incremental pieces → the same as at once, seed matters", "[functional_requirements]") {
+        std::string data;
+        for (int i = 0; i != 1000; ++i) data += std::to_string(i * i) + ';';
+
+        Hash64 hash;
+        for (std::size_t offset = 0, step = 1; offset < data.size(); offset += step, step = step * 5 % 71 + 1) {
+            hash.update(std::string_view(data).substr(offset, step));
+        }
+
+        REQUIRE(hash.value() == Hash64::Of(data));
+        REQUIRE(Hash64::Of(data, 1) != Hash64::Of(data));
+
+        hash.reset();
+        REQUIRE(hash.value() == Hash64::Of(""));
+    }
+
+}
+
+TEST_CASE("ChecksumBuffer", "[libs][facilities][hashing][ChecksumBuffer]")
+{
+    using hlibs::facilities::hashing::CRC32C;
+    using hlibs::facilities::hashing::Hash64;
+    using hlibs::standard::compression::Frame;
+    using hlibs::io::FileWriter;
+    using hlibs::io::FileLoader;
+    using hlibs::io::FileReader;
+
+    SECTION("checksum while writing and reading → equal to the content hash", "[use_case]") {
+        const std::filesystem::path path("../../outputs/hashing-checksum-1-write-read.txt");
+        const std::string piece(20000, 'p');
+        std::string expected;
+        CRC32C written;
+
+        {
+            FileWriter writer(path);
+            writer.checksum(written);
+            writer.write("head\n");
+            writer.integer(42);
+            writer.gather({piece, std::string_view("\n")});
+            expected = "head\n42" + piece + '\n';
+            REQUIRE_THROWS_AS(writer.position(), std::logic_error);
+            REQUIRE_THROWS_AS(writer.checksum(written), std::logic_error);
+            writer.write("tail\n");
+            expected += "tail\n";
+        }
+
+        REQUIRE(written.value() == CRC32C::Of(expected));
+
+        CRC32C loaded;
+        FileLoader loader(path);
+        loader.read(loaded);
+        REQUIRE(loaded.value() == written.value());
+        REQUIRE(loader.data().size() == expected.size());
+
+        Hash64 lines;
+        FileReader reader(path);
+        reader.checksum(lines);
+        REQUIRE_THROWS_AS(reader.checksum(lines), std::logic_error);
+        while (reader.hasNextLine()) reader.getNextLine();
+        REQUIRE(lines.value() == Hash64::Of(expected));
+    }
+
+    SECTION("checksum of compressed file → over the uncompressed bytes", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/hashing-checksum-2-compressed.hlz");
+        Hash64 written;
+
+        {
+            FileWriter writer(path, std::ios::trunc, Frame{});
+            writer.checksum(written);
+            for (int i = 0; i != 1000; ++i) writer.write("repeated line\n");
+        }
+
+        Hash64 loaded;
+        FileLoader loader(path);
+        loader.read(loaded);
+        REQUIRE(loader.data().size() == 14000);
+        REQUIRE(loaded.value() == written.value());
+    }
+
+}
@@ -0,0 +1,85 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "../../sources/facilities/interning.hpp"
+
+
+TEST_CASE("StringPool", "[libs][facilities][interning][StringPool]")
+{
+    using hlibs::facilities::interning::StringPool;
+    using hlibs::facilities::interning::ID;
+
+    SECTION("the same text twice → the same ID and stored view", "[basic_check]") {
+        StringPool pool;
+        std::string text = "main.cpp";
+
+        auto id = pool.intern(text);
+        auto view = pool.view(id);
+        text[0] = 'M';
+
+        REQUIRE(pool.intern("main.cpp") == id);
+        REQUIRE(pool.intern(text) != id);
+        REQUIRE(view == "main.cpp");
+        REQUIRE(view.data() == pool("main.cpp").data());
+        REQUIRE(pool.find("main.cpp") == id);
+        REQUIRE(!pool.find("absent"));
+        REQUIRE(pool.size() == 2);
+        REQUIRE(pool.bytes() == 16);
+    }
+
+    SECTION("many texts, some larger than a chunk → earlier views stay valid", "[memory]") {
+        StringPool pool(64);
+        std::vector<std::pair<ID, std::string_view>> interned;
+
+        for (int i = 0; i != 5000; ++i) {
+            auto text = "string-" + std::to_string(i) + (i % 100 == 0 ? std::string(100, 'x') : "");
+            auto id = pool.intern(text);
+            interned.emplace_back(id, pool.view(id));
+        }
+
+        REQUIRE(pool.size() == 5000);
+        for (int i = 0; i < 5000; i += 7) {
+            auto text = "string-" + std::to_string(i) + (i % 100 == 0 ? std::string(100, 'x') : "");
+            REQUIRE(interned[static_cast<std::size_t>(i)].second == text);
+            REQUIRE(pool.intern(text) == interned[static_cast<std::size_t>(i)].first);
+        }
+    }
+
+    SECTION("many threads interning the same texts → one ID per text", "[use_case]") {
+        StringPool pool;
+        std::vector<std::vector<ID>> ids(8);
+
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t t = 0; t != ids.size(); ++t) {
+                threads.emplace_back([&pool, &ids, t] {
+                    for (int i = 0; i != 2000; ++i) ids[t].push_back(pool.intern("name-" + std::to_string(i)));
+                });
+            }
+        }
+
+        REQUIRE(pool.size() == 2000);
+        for (const auto& each : ids) REQUIRE(each == ids.front());
+    }
+
+}
+
+TEST_CASE("SiteOf", "[libs][facilities][interning][SiteOf]")
+{
+    using hlibs::facilities::interning::SiteOf;
+    using Source = std::experimental::source_location;
+
+    SECTION("call site → base name of the file and function, cached", "[functional_requirements]") {
+        auto here = [] { return Source::current(); };
+        const auto& site = SiteOf(here());
+        const auto& again = SiteOf(here());
+
+        REQUIRE(site.file == "interning_test.cpp");
+        REQUIRE(site.function == here().function_name());
+        REQUIRE(&site == &again);
+        REQUIRE(site.file.data() == hlibs::facilities::interning::StringPool::Global()("interning_test.cpp").data());
+    }
+
+}
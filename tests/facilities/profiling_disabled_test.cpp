@@ -0,0 +1,22 @@
+#include <catch2/catch_test_macros.hpp>
+#include <type_traits>
+
+#define HLIBS_PROFILING 0
+#include "../../sources/facilities/profiling.hpp"
+
+
+TEST_CASE("Zone (HLIBS_PROFILING=0)", "[libs][facilities][profiling][Zone]")
+{
+    using namespace hlibs::facilities::profiling;
+
+    SECTION("profiling compiled out → Zone is an empty class, nothing recorded", "[type_traits]") {
+        REQUIRE(std::is_empty_v<Zone>);
+
+        Profiler::Global().clear();
+        {
+            Zone zone("compiled out");
+        }
+        REQUIRE(Profiler::Global().collect().empty());
+    }
+
+}
@@ -0,0 +1,237 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <cstring>
+
+#include "../../sources/facilities/profiling.hpp"
+#include "../../sources/io/helper_objects.hpp"
+
+
+namespace {
+
+    /// Sink collecting everything written to it.
+    struct StringSink {
+        std::string bytes;
+
+        void write(std::string_view text)
+        {
+            bytes += text;
+        }
+    };
+
+    void Profiled(int depth)
+    {
+        hlibs::facilities::profiling::Zone zone;
+        if (depth != 0) Profiled(depth - 1);
+    }
+
+}
+
+
+TEST_CASE("Profiler", "[libs][facilities][profiling][Profiler]")
+{
+    using namespace hlibs::facilities::profiling;
+
+    SECTION("first zones of a thread, before Profiler::Global() → begin after the origin, no setup in the duration", "[functional_requirements]") {
+        std::thread([] {
+            Zone outer("first outer");
+            Zone inner("first inner");
+        }).join();
+
+        auto records = Profiler::Global().collect();
+        auto outer = std::ranges::find(records, std::string_view("first outer"), &Record::name);
+        auto inner = std::ranges::find(records, std::string_view("first inner"), &Record::name);
+        REQUIRE(outer != records.end());
+        REQUIRE(inner != records.end());
+
+        REQUIRE(outer->begin < 3'600'000'000'000);
+        REQUIRE(inner->begin >= outer->begin);
+        REQUIRE(inner->begin + inner->duration <= outer->begin + outer->duration);
+        REQUIRE(outer->duration < 1'000'000);
+    }
+
+    SECTION("nested zones in many threads → one record per zone, inner within outer", "[functional_requirements]") {
+        auto& profiler = Profiler::Global();
+        profiler.clear();
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i != 4; ++i) {
+            threads.emplace_back([] {
+                Zone outer("outer");
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                Profiled(2);
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        auto records = profiler.collect();
+        REQUIRE(records.size() == 16);
+
+        for (const auto& record : records) {
+            if (record.name != "outer") continue;
+            REQUIRE(record.duration >= 2000000);
+            REQUIRE(record.file == "profiling_test.cpp");
+
+            auto inner = std::ranges::count_if(records, [&](const Record& other) {
+                return other.thread == record.thread && other.name != "outer" && other.begin >= record.begin && other.begin + other.duration <= record.begin + record.duration;
+            });
+            REQUIRE(inner == 3);
+        }
+
+        REQUIRE_THAT(std::string(records.back().name), Catch::Matchers::Contains("Profiled"));
+        REQUIRE(profiler.dropped() == 0);
+        profiler.clear();
+        REQUIRE(profiler.collect().empty());
+    }
+
+    SECTION("more zones than the capacity → the latest kept, the rest dropped", "[memory]") {
+        Profiler profiler(16);
+        const auto location = Profiler::Source::current();
+
+        for (std::uint64_t i = 0; i != 100; ++i) profiler.record("step", location, i, i + 1);
+
+        auto records = profiler.collect();
+        REQUIRE(profiler.capacity() == 16);
+        REQUIRE(records.size() == 16);
+        REQUIRE(profiler.dropped() == 84);
+        REQUIRE(std::ranges::is_sorted(records, {}, &Record::begin));
+    }
+
+    SECTION("buffer of the thread cannot be allocated → zone left unrecorded, no termination", "[memory]") {
+        Profiler profiler(1UL << 60);
+        const auto location = Profiler::Source::current();
+
+        profiler.record("lost", location, 1, 2);
+        REQUIRE(profiler.collect().empty());
+    }
+
+    SECTION("collected while threads record → no torn records", "[multithreading]") {
+        Profiler profiler(64);
+        std::atomic<bool> stop = false;
+        std::vector<std::thread> threads;
+
+        for (int i = 0; i != 3; ++i) {
+            threads.emplace_back([&] {
+                const auto location = Profiler::Source::current();
+                for (std::uint64_t n = 0; !stop; ++n) profiler.record("busy", location, n, n * 2);
+            });
+        }
+
+        for (int i = 0; i != 200; ++i) {
+            for (const auto& record : profiler.collect()) {
+                REQUIRE(record.name == "busy");
+            }
+        }
+
+        stop = true;
+        for (auto& thread : threads) thread.join();
+    }
+
+}
+
+TEST_CASE("Stopwatch", "[libs][facilities][profiling][Stopwatch]")
+{
+    using hlibs::facilities::profiling::Stopwatch;
+
+    SECTION("sleep of 5 ms → about 5 ms elapsed", "[functional_requirements]") {
+        Stopwatch stopwatch;
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        auto elapsed = stopwatch.elapsed();
+
+        REQUIRE(elapsed >= std::chrono::microseconds(4900));
+        REQUIRE(elapsed < std::chrono::seconds(1));
+        REQUIRE(Stopwatch::Rate() > 0);
+    }
+
+}
+
+TEST_CASE("ExportChromeTrace", "[libs][facilities][profiling][ExportChromeTrace]")
+{
+    using namespace hlibs::facilities::profiling;
+
+    const std::vector<Record> records{
+            {"load \"config\"", "main.cpp", "int main()", 12, 1, 1500, 250000},
+            {"parse", "main.cpp", "void parse(std::string_view)", 40, 2, 2000, 999}
+    };
+
+    SECTION("records → complete events in µs, names escaped", "[functional_requirements]") {
+        StringSink sink;
+        ExportChromeTrace(records, sink);
+
+        REQUIRE_THAT(sink.bytes, Catch::Matchers::StartsWith(R"({"displayTimeUnit":"ns","traceEvents":[{"name":"load \"config\"","cat":"zone","ph":"X","pid":1,"tid":1,"ts":1.500,"dur":250.000,)"));
+        REQUIRE_THAT(sink.bytes, Catch::Matchers::Contains(R"json("args":{"file":"main.cpp","line":40,"function":"void parse(std::string_view)"}})json"));
+        REQUIRE_THAT(sink.bytes, Catch::Matchers::EndsWith("}}]}"));
+    }
+
+    SECTION("zones of the global profiler into FileWriter → trace file", "[use_case]") {
+        const std::filesystem::path path("../../outputs/profiling-1-trace.json");
+        Profiler::Global().clear();
+        Profiled(3);
+
+        {
+            hlibs::io::FileWriter writer(path);
+            ExportChromeTrace(Profiler::Global().collect(), writer);
+        }
+
+        REQUIRE(std::filesystem::file_size(path) > 100);
+    }
+
+}
+
+TEST_CASE("ExportBinary", "[libs][facilities][profiling][ExportBinary]")
+{
+    using namespace hlibs::facilities::profiling;
+
+    SECTION("records → the same records imported back, sites stored once", "[functional_requirements]") {
+        std::vector<Record> records;
+        for (std::uint32_t i = 0; i != 1000; ++i) {
+            records.push_back({i % 2 ? "odd" : "even", "file.cpp", "void f()", i % 2, i % 3 + 1, i * 1000ULL, i});
+        }
+
+        StringSink sink;
+        ExportBinary(records, sink);
+
+        REQUIRE(sink.bytes.size() < 24 * records.size() + 200);
+        REQUIRE(ImportBinary(sink.bytes) == records);
+    }
+
+    SECTION("truncated or foreign bytes → exception", "[exceptions]") {
+        StringSink sink;
+        ExportBinary({{"zone", "a.cpp", "f", 1, 1, 2, 3}}, sink);
+
+        REQUIRE_THROWS_AS(ImportBinary(std::string_view(sink.bytes).substr(0, sink.bytes.size() - 1)), std::invalid_argument);
+        REQUIRE_THROWS_AS(ImportBinary("{\"traceEvents\":[]}"), std::invalid_argument);
+    }
+
+    SECTION("counts beyond the bytes → exception before allocating", "[exceptions]") {
+        StringSink sink;
+        ExportBinary({{"zone", "a.cpp", "f", 1, 1, 2, 3}}, sink);
+
+        auto sites = sink.bytes;
+        std::memset(sites.data() + BinaryMagic.size(), 0xFF, 4);
+        auto records = sink.bytes;
+        std::memset(records.data() + BinaryMagic.size() + 4, 0xFF, 8);
+
+        REQUIRE_THROWS_AS(ImportBinary(sites), std::invalid_argument);
+        REQUIRE_THROWS_AS(ImportBinary(records), std::invalid_argument);
+    }
+
+}
+
+TEST_CASE("Zone benchmark", "[.][benchmark][libs][facilities][profiling][Zone]")
+{
+    using namespace hlibs::facilities::profiling;
+
+    BENCHMARK("Zone (record one)") {
+        Zone zone("benchmark");
+    };
+
+    BENCHMARK("std::chrono::steady_clock::now() × 2") {
+        return std::chrono::steady_clock::now() - std::chrono::steady_clock::now();
+    };
+}
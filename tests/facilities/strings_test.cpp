@@ -1,6 +1,13 @@
 #include <catch2/catch_test_macros.hpp>
 #include <catch2/matchers/catch_matchers_string.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <string>
+#include <array>
+#include <vector>
+#include <regex>
+#include <limits>
+#include <cstdint>
+#include <cctype>
 
 #include "../../sources/facilities/strings.hpp"
 
@@ -38,6 +45,63 @@ TEST_CASE("ToUpperCase", "[libs][facilities][strings][ToUpperCase]")
 
 }
 
+TEST_CASE("ToLowerCase", "[libs][facilities][strings][ToLowerCase]")
+{
+    using namespace hlibs::facilities::strings;
+
+    SECTION("long mixed text with UTF-8 → only ASCII letters converted", "[functional_requirements]") {
+        const std::string input = "Zażółć GĘŚLĄ Jaźń, 0123 [@`{] and A LONGER TAIL OF ASCII TEXT";
+        const std::string lower = "zażółć gĘŚlĄ jaźń, 0123 [@`{] and a longer tail of ascii text";
+        const std::string upper = "ZAżółć GĘŚLĄ JAźń, 0123 [@`{] AND A LONGER TAIL OF ASCII TEXT";
+
+        REQUIRE(ToLowerCase(input) == lower);
+        REQUIRE(ToUpperCase(input) == upper);
+    }
+
+    SECTION("in place and into a buffer → no allocation, too small throws", "[basic_check]") {
+        std::string text = "Mixed Case Text";
+        std::array<char, 15> buffer{};
+
+        ToLowerCaseInPlace(text);
+        REQUIRE(text == "mixed case text");
+        ToUpperCaseInPlace(text);
+        REQUIRE(text == "MIXED CASE TEXT");
+
+        REQUIRE(ToLowerCase("Mixed Case Text", buffer) == 15);
+        REQUIRE(std::string_view(buffer.data(), buffer.size()) == "mixed case text");
+        REQUIRE_THROWS_AS(ToUpperCase("Mixed Case Text!", buffer), std::length_error);
+    }
+
+}
+
+TEST_CASE("CompareIgnoreCase", "[libs][facilities][strings][CompareIgnoreCase]")
+{
+    using hlibs::facilities::strings::CompareIgnoreCase;
+    using hlibs::facilities::strings::EqualsIgnoreCase;
+
+    SECTION("texts differing only in case → equal", "[functional_requirements]") {
+        const std::string lhs = "Content-Type: Application/JSON; Charset=UTF-8";
+        const std::string rhs = "content-type: application/json; charset=utf-8";
+
+        REQUIRE(EqualsIgnoreCase(lhs, rhs));
+        REQUIRE(CompareIgnoreCase(lhs, rhs) == 0);
+        REQUIRE(EqualsIgnoreCase("", ""));
+    }
+
+    SECTION("different letters, lengths or non-letters → ordered like the lowercase texts", "[functional_requirements]") {
+        const std::string base(40, 'a');
+
+        REQUIRE(!EqualsIgnoreCase(base + "B", base + "c"));
+        REQUIRE(CompareIgnoreCase(base + "B", base + "c") < 0);
+        REQUIRE(CompareIgnoreCase(base + "c", base + "B") > 0);
+        REQUIRE(CompareIgnoreCase(base, base + "A") < 0);
+        REQUIRE(CompareIgnoreCase("[", "a") < 0);           // '[' sits between 'Z' and 'a'
+        REQUIRE(!EqualsIgnoreCase("@", "`"));
+        REQUIRE(CompareIgnoreCase("\xC4\x85", "z") > 0);
+    }
+
+}
+
 TEST_CASE("Contains", "[libs][facilities][strings][Contains]")
 {
     using hlibs::facilities::strings::Contains;
@@ -139,6 +203,56 @@ TEST_CASE("IsNumber", "[libs][facilities][strings][IsNumber]")
 
 }
 
+TEST_CASE("CheckRange", "[libs][facilities][strings][CheckRange]")
+{
+    using hlibs::facilities::strings::CheckRange;
+    using hlibs::facilities::strings::FindNotIn;
+    using hlibs::facilities::strings::CharClass;
+
+    SECTION("every byte, alone and in a long text, any combination of classes → the same as the C locale <cctype>", "[functional_requirements]") {
+        const auto reference = [](unsigned char byte, unsigned classes) {
+            bool in = false;
+            if (classes & 1U) in |= std::isalpha(byte) != 0;
+            if (classes & 2U) in |= std::isdigit(byte) != 0;
+            if (classes & 4U) in |= std::ispunct(byte) != 0 || byte == ' ';
+            if (classes & 8U) in |= std::iscntrl(byte) != 0;
+            return in;
+        };
+
+        for (unsigned classes = 1; classes != 16; ++classes) {
+            const auto set = static_cast<CharClass>(classes);
+            std::string member;
+            for (unsigned byte = 0; byte != 256; ++byte) {
+                if (reference(static_cast<unsigned char>(byte), classes)) member = std::string(1, static_cast<char>(byte));
+            }
+
+            for (unsigned byte = 0; byte != 256; ++byte) {
+                const auto ch = static_cast<char>(byte);
+                const bool in = reference(static_cast<unsigned char>(byte), classes);
+                REQUIRE(CheckRange(std::string_view(&ch, 1), set) == in);
+
+                for (std::size_t at : {0UL, 15UL, 31UL, 47UL, 100UL, 140UL}) {
+                    std::string text(141, member.front());
+                    text[at] = ch;
+                    REQUIRE(FindNotIn(text, set) == (in ? std::string_view::npos : at));
+                }
+            }
+        }
+    }
+
+    SECTION("named classes → letters, digits, alphanumerics, ASCII", "[functional_requirements]") {
+        REQUIRE(CheckRange("Identifier", CharClass::Letters));
+        REQUIRE(CheckRange("id42", CharClass::Alphanumerics));
+        REQUIRE(!CheckRange("id_42", CharClass::Alphanumerics));
+        REQUIRE(CheckRange("id_42", CharClass::Alphanumerics | CharClass::Special));
+        REQUIRE(CheckRange("line\r\n", CharClass::ASCII));
+        REQUIRE(!CheckRange("Ala ma kota, a kot ma Alę", CharClass::ASCII));
+        REQUIRE(FindNotIn("Ala ma kota, a kot ma Alę", CharClass::ASCII) == 24);
+        REQUIRE(CheckRange("", CharClass::Digits));
+    }
+
+}
+
 TEST_CASE("IsNumeric", "[libs][facilities][strings][IsNumeric]")
 {
 
@@ -162,4 +276,185 @@ TEST_CASE("IsNumeric", "[libs][facilities][strings][IsNumeric]")
         REQUIRE(!IsNumeric("2-0.0+5.24"));
     }
 
+    SECTION("edge cases of the notation → the same as the regex", "[functional_requirements]") {
+        REQUIRE(IsNumeric("1."));
+        REQUIRE(IsNumeric("-0.000"));
+        REQUIRE(!IsNumeric(""));
+        REQUIRE(!IsNumeric("+"));
+        REQUIRE(!IsNumeric("-."));
+        REQUIRE(!IsNumeric("1.2.3"));
+        REQUIRE(!IsNumeric("1e5"));
+        REQUIRE(!IsNumeric("inf"));
+        REQUIRE(!IsNumeric("\xD9\xA3"));
+    }
+
+}
+
+TEST_CASE("ParseNumeric", "[libs][facilities][strings][ParseNumeric]")
+{
+    using hlibs::facilities::strings::ParseNumeric;
+    using hlibs::facilities::strings::FindNonNumeric;
+
+    SECTION("valid notations → parsed values", "[functional_requirements]") {
+        REQUIRE(ParseNumeric<int>("+100") == 100);
+        REQUIRE(ParseNumeric<long long>("-9223372036854775808") == std::numeric_limits<long long>::min());
+        REQUIRE(ParseNumeric<double>("-100.25") == -100.25);
+        REQUIRE(ParseNumeric<double>("7.") == 7.0);
+        REQUIRE(ParseNumeric<float>("+0.5") == 0.5F);
+    }
+
+    SECTION("invalid notations, fractions for integers, out of range → nullopt", "[functional_requirements]") {
+        REQUIRE(!ParseNumeric<double>(".5"));
+        REQUIRE(!ParseNumeric<double>("1e5"));
+        REQUIRE(!ParseNumeric<int>("1.0"));
+        REQUIRE(!ParseNumeric<int>("2147483648"));
+        REQUIRE(!ParseNumeric<unsigned>("-1"));
+        REQUIRE(!ParseNumeric<std::int8_t>("128"));
+    }
+
+    SECTION("column of texts → first invalid index, values parsed up to it", "[use_case]") {
+        const std::vector<std::string_view> valid = {"1", "-2.5", "+3.", "40"};
+        const std::vector<std::string_view> invalid = {"1", "2", "x3", "4"};
+        std::array<double, 4> values{};
+
+        REQUIRE(FindNonNumeric(valid) == std::string_view::npos);
+        REQUIRE(FindNonNumeric(invalid) == 2);
+        REQUIRE(ParseNumeric<double>(valid, values) == 4);
+        REQUIRE(values == std::array<double, 4>{1, -2.5, 3, 40});
+        REQUIRE(ParseNumeric<double>(invalid, values) == 2);
+        REQUIRE_THROWS_AS(ParseNumeric<double>(valid, std::span<double>(values.data(), 3)), std::length_error);
+    }
+
+}
+
+TEST_CASE("Split", "[libs][facilities][strings][Split]")
+{
+    using hlibs::facilities::strings::Split;
+    using hlibs::facilities::strings::AnyOf;
+    using hlibs::facilities::strings::SplitView;
+
+    constexpr auto collect = [](SplitView tokens) {
+        std::vector<std::string> result;
+        for (auto token : tokens) result.emplace_back(token);
+        return result;
+    };
+
+    SECTION("is a lazy forward view → true", "[type_traits]") {
+        REQUIRE(std::ranges::view<SplitView>);
+        REQUIRE(std::ranges::forward_range<SplitView>);
+    }
+
+    SECTION("single character → tokens with empty ones kept or skipped", "[functional_requirements]") {
+        const std::string line = ",a,,bc,";
+
+        REQUIRE(collect(Split(line, ',')) == std::vector<std::string>{"", "a", "", "bc", ""});
+        REQUIRE(collect(Split(line, ',', true)) == std::vector<std::string>{"a", "bc"});
+        REQUIRE(collect(Split("abc", ',')) == std::vector<std::string>{"abc"});
+        REQUIRE(collect(Split("", ',')).empty());
+    }
+
+    SECTION("sequence and set of characters → tokens between them", "[functional_requirements]") {
+        const std::string text = std::string(40, 'x') + "::y:z::::" + std::string(40, 'w');
+
+        REQUIRE(collect(Split(text, "::")) == std::vector<std::string>{std::string(40, 'x'), "y:z", "", std::string(40, 'w')});
+        REQUIRE(collect(Split(text, "::", true)).size() == 3);
+        REQUIRE(collect(Split("key = value;\tnext", AnyOf{" =;\t"}, true)) == std::vector<std::string>{"key", "value", "next"});
+        REQUIRE_THROWS_AS(Split(text, ""), std::invalid_argument);
+    }
+
+    SECTION("tokens point into the text → nothing copied", "[memory]") {
+        const std::string text = "alpha beta gamma";
+        auto tokens = Split(text, ' ');
+
+        REQUIRE((*std::ranges::next(tokens.begin(), 2)).data() == text.data() + 11);
+        REQUIRE(std::ranges::distance(tokens) == 3);
+    }
+
+}
+
+TEST_CASE("Keywords", "[libs][facilities][strings][Keywords]")
+{
+    using hlibs::facilities::strings::Keywords;
+    using hlibs::facilities::strings::Match;
+    using hlibs::facilities::strings::Contains;
+
+    SECTION("overlapping keywords → all occurrences in the order of their ends", "[functional_requirements]") {
+        const Keywords keywords{"he", "she", "his", "hers"};
+
+        auto matches = keywords.findAll("ushers and his");
+
+        REQUIRE(keywords.size() == 4);
+        REQUIRE(matches == std::vector<Match>{{1, 1}, {0, 2}, {3, 2}, {2, 11}});
+        REQUIRE(keywords.findFirst("ushers") == Match{1, 1});
+        REQUIRE(keywords[matches.back().pattern] == "his");
+    }
+
+    SECTION("ignoring case, keywords from a vector → matched in any case", "[functional_requirements]") {
+        const std::vector<std::string> list = {"Timeout", "refused", "\xC4\x85"};
+        const Keywords keywords(list, true);
+
+        REQUIRE(Contains("connection REFUSED", keywords));
+        REQUIRE(Contains("TIMEOUT", keywords));
+        REQUIRE(Contains("za\xC4\x85", keywords));
+        REQUIRE(!Contains("time out, refuse", keywords));
+        REQUIRE(!Contains("", keywords));
+        REQUIRE(!Keywords({"Timeout"}).findFirst("timeout"));
+    }
+
+    SECTION("keywords using all 256 bytes → every byte in its own class", "[basic_check]") {
+        std::string all(256, '\0');
+        for (std::size_t i = 0; i != all.size(); ++i) all[i] = static_cast<char>(i);
+        const Keywords keywords{all, "\xFF"};
+
+        REQUIRE(keywords.findFirst("ab\xFF") == Match{1, 2});
+        REQUIRE(keywords.findAll("x" + all) == std::vector<Match>{{0, 1}, {1, 256}});
+        REQUIRE(!keywords.findFirst(all.substr(0, 255)));
+    }
+
+    SECTION("empty keyword → exception", "[exceptions]") {
+        REQUIRE_THROWS_AS(Keywords({"a", ""}), std::invalid_argument);
+    }
+
+}
+
+TEST_CASE("IsNumeric benchmark", "[.][benchmark][libs][facilities][strings][IsNumeric]")
+{
+    using hlibs::facilities::strings::IsNumeric;
+    using hlibs::facilities::strings::ParseNumeric;
+
+    std::vector<std::string> texts;
+    for (int i = 0; i != 1000; ++i) texts.push_back(i % 5 == 0 ? "x" + std::to_string(i) : std::to_string(i * 37 - 9000) + ".25");
+    std::vector<std::string_view> column(texts.begin(), texts.end());
+
+    BENCHMARK("regex_match (the former IsNumeric)") {
+        return std::ranges::count_if(texts, [](const std::string& str) {
+            std::regex number("((\\+|-)?[[:digit:]]+)(\\.(([[:digit:]]+)?))?");
+            return std::regex_match(str, number);
+        });
+    };
+
+    BENCHMARK("IsNumeric") {
+        return std::ranges::count_if(column, IsNumeric);
+    };
+
+    BENCHMARK("ParseNumeric<double>") {
+        return std::ranges::count_if(column, [](std::string_view str) { return ParseNumeric<double>(str).has_value(); });
+    };
+}
+
+TEST_CASE("CheckRange benchmark", "[.][benchmark][libs][facilities][strings][CheckRange]")
+{
+    using hlibs::facilities::strings::CheckRange;
+    using hlibs::facilities::strings::CharClass;
+
+    std::string text;
+    for (int i = 0; text.size() < (1UL << 20); ++i) text += "field_" + std::to_string(i) + " = Value" + std::to_string(i * 7) + ";\t";
+
+    BENCHMARK("std::all_of with std::isprint/std::isspace (1 MiB)") {
+        return std::all_of(text.begin(), text.end(), [](char ch) { return std::isprint(static_cast<unsigned char>(ch)) || std::isspace(static_cast<unsigned char>(ch)); });
+    };
+
+    BENCHMARK("CheckRange(Alphanumerics | Special | ControlChars) (1 MiB)") {
+        return CheckRange(text, CharClass::Alphanumerics | CharClass::Special | CharClass::ControlChars);
+    };
 }
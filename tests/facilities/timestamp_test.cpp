@@ -1,8 +1,19 @@
 #include <catch2/catch_test_macros.hpp>
+#include <catch2/benchmark/catch_benchmark.hpp>
 #include <cctype>
 #include <chrono>
 #include <ranges>
 #include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <ctime>
+#include <cstdio>
+#include <cstdlib>
+#include <atomic>
 
 #include "../../sources/facilities/timestamp.hpp"
 #include "../../sources/facilities/strings.hpp"
@@ -65,4 +76,166 @@ TEST_CASE("DateTime", "[libs][facilities][timestamp][DateTime]")
         REQUIRE(isNumber);
     }
 
+    SECTION("given moment → the fields of localtime_r(), ISO 8601 with any precision", "[functional_requirements]") {
+        using namespace std::chrono;
+        using hlibs::facilities::timestamp::Precision;
+
+        const auto moment = sys_days(year(2024) / 2 / 29) + hours(23) + minutes(59) + seconds(58) + nanoseconds(123456789);
+        const DateTime dt(time_point_cast<DateTime::Clock::duration>(moment));
+
+        const std::time_t time = DateTime::Clock::to_time_t(dt.point);
+        std::tm local{};
+        localtime_r(&time, &local);
+        std::array<char, 32> expected{};
+        std::strftime(expected.data(), expected.size(), "%Y-%m-%d %H:%M:%S", &local);
+
+        REQUIRE(dt.timestamp() == expected.data());
+        REQUIRE(dt.offset.count() == local.tm_gmtoff);
+
+        std::strftime(expected.data(), expected.size(), "%Y-%m-%dT%H:%M:%S", &local);
+        const auto minutes = static_cast<int>(local.tm_gmtoff / 60);
+        std::array<char, 16> zone{};
+        std::snprintf(zone.data(), zone.size(), "%c%02d:%02d", minutes < 0 ? '-' : '+', std::abs(minutes) / 60, std::abs(minutes) % 60);
+
+        REQUIRE(dt.iso8601() == std::string(expected.data()) + zone.data());
+        REQUIRE(dt.iso8601(Precision::Milliseconds) == std::string(expected.data()) + ".123" + zone.data());
+        REQUIRE(dt.iso8601(Precision::Microseconds) == std::string(expected.data()) + ".123456" + zone.data());
+        REQUIRE(dt.iso8601(Precision::Nanoseconds).size() == DateTime::MaxLength);
+
+        std::array<char, 20> small{};
+        REQUIRE_THROWS_AS(dt.iso8601(small), std::length_error);
+    }
+
+    SECTION("days from civil and back → the same as std::chrono::year_month_day", "[functional_requirements]") {
+        using namespace std::chrono;
+        using hlibs::facilities::timestamp::DaysFromCivil;
+        using hlibs::facilities::timestamp::CivilFromDays;
+
+        static_assert(DaysFromCivil({1970, 1, 1}) == 0);
+
+        for (int count = -800000; count <= 800000; count += 7) {
+            const year_month_day ymd{sys_days(days(count))};
+            const auto civil = CivilFromDays(count);
+            REQUIRE(civil.year == static_cast<int>(ymd.year()));
+            REQUIRE(civil.month == static_cast<unsigned>(ymd.month()));
+            REQUIRE(civil.day == static_cast<unsigned>(ymd.day()));
+            REQUIRE(DaysFromCivil(civil) == count);
+        }
+    }
+
+    SECTION("constructed from many threads → the same as from one", "[multithreading]") {
+        const auto moment = DateTime::Clock::now();
+        const auto expected = DateTime(moment).iso8601();
+        std::vector<std::thread> threads;
+        std::atomic<int> mismatches = 0;
+
+        for (int i = 0; i != 8; ++i) {
+            threads.emplace_back([&] {
+                for (int j = 0; j != 10000; ++j) {
+                    if (DateTime(moment).iso8601() != expected) ++mismatches;
+                }
+            });
+        }
+        for (auto& thread : threads) thread.join();
+
+        REQUIRE(mismatches == 0);
+    }
+
+}
+
+TEST_CASE("ParseTimestamp", "[libs][facilities][timestamp][ParseTimestamp]")
+{
+    using namespace std::chrono;
+    using hlibs::facilities::timestamp::DateTime;
+    using hlibs::facilities::timestamp::Precision;
+    using hlibs::facilities::timestamp::ParseTimestamp;
+    using hlibs::facilities::timestamp::ParseFilestamp;
+    using hlibs::facilities::timestamp::ParseISO8601;
+
+    SECTION("texts of DateTime at random moments → the same moments back", "[functional_requirements]") {
+        std::mt19937_64 random(49);
+        std::uniform_int_distribution<std::int64_t> nanoseconds_since_epoch(0, 4102444800LL * 1000000000LL);
+
+        for (int i = 0; i != 20000; ++i) {
+            const DateTime::Clock::time_point moment{duration_cast<DateTime::Clock::duration>(nanoseconds(nanoseconds_since_epoch(random)))};
+            const DateTime dt(moment);
+
+            REQUIRE(ParseTimestamp(dt.timestamp(), dt.offset) == floor<seconds>(moment));
+            REQUIRE(ParseFilestamp(dt.filestamp(), dt.offset) == floor<seconds>(moment));
+            REQUIRE(ParseISO8601(dt.iso8601(Precision::Nanoseconds)) == moment);
+            REQUIRE(ParseISO8601(dt.iso8601(Precision::Milliseconds)) == floor<milliseconds>(moment));
+        }
+    }
+
+    SECTION("other zones, short fractions, no zone → offsets and fractions applied", "[functional_requirements]") {
+        const auto moment = sys_days(year(2001) / 9 / 9) + hours(1) + minutes(46) + seconds(40);
+
+        REQUIRE(ParseISO8601("2001-09-09T01:46:40Z") == moment);
+        REQUIRE(ParseISO8601("2001-09-09 01:46:40") == moment);
+        REQUIRE(ParseISO8601("2001-09-09T03:46:40.5+02:00") == moment + milliseconds(500));
+        REQUIRE(ParseISO8601("2001-09-08T20:16:40.0123456789-0530") == moment + nanoseconds(12345678));
+        REQUIRE(ParseTimestamp("2001-09-09 01:46:40") == moment);
+        REQUIRE(ParseFilestamp("20010909_014640") == moment);
+    }
+
+    SECTION("wrong characters, lengths, dates out of range → nullopt", "[functional_requirements]") {
+        for (std::string_view text : {"2001-09-09 01:46:4", "2001-09-09 01:46:400", "2001/09/09 01:46:40", "2001-09-09T01:46:40",
+                                      "2001-0a-09 01:46:40", "2001-13-09 01:46:40", "2001-00-09 01:46:40", "2001-02-29 01:46:40",
+                                      "2001-04-31 01:46:40", "2001-09-09 24:00:00", "2001-09-09 23:60:00", "2001-09-09 23:59:60",
+                                      "2001-09-09 01:46:4:", "2001-09-09 01:46:\0"}) {
+            REQUIRE(!ParseTimestamp(text));
+        }
+
+        REQUIRE(ParseTimestamp("2000-02-29 00:00:00"));
+        REQUIRE(!ParseTimestamp("1900-02-29 00:00:00"));
+        REQUIRE(!ParseFilestamp("20010909-014640"));
+        REQUIRE(!ParseISO8601("2001-09-09T01:46:40."));
+        REQUIRE(!ParseISO8601("2001-09-09T01:46:40+2"));
+        REQUIRE(!ParseISO8601("2001-09-09T01:46:40+02:60"));
+        REQUIRE(!ParseISO8601("2001-09-09T01:46:40Zx"));
+        REQUIRE(!ParseISO8601("2001-09-09X01:46:40"));
+    }
+
+    SECTION("column of timestamps → first invalid index, moments parsed up to it", "[use_case]") {
+        const std::vector<std::string_view> column{"2024-01-01 00:00:00", "2024-01-01 00:00:01", "2024-01-01 0:00:02", "2024-01-01 00:00:03"};
+        std::vector<sys_seconds> moments(column.size());
+        std::vector<sys_seconds> few(2);
+
+        REQUIRE(ParseTimestamp(column, moments) == 2);
+        REQUIRE(moments[1] - moments[0] == seconds(1));
+        REQUIRE_THROWS_AS(ParseTimestamp(column, few), std::length_error);
+
+        std::vector<sys_time<nanoseconds>> precise(1);
+        const std::vector<std::string_view> iso{"2024-01-01T00:00:00.000000001Z"};
+        REQUIRE(ParseISO8601(iso, precise) == 1);
+        REQUIRE(precise[0].time_since_epoch() % seconds(1) == nanoseconds(1));
+    }
+
+}
+
+TEST_CASE("ParseTimestamp benchmark", "[.][benchmark][libs][facilities][timestamp][ParseTimestamp]")
+{
+    using hlibs::facilities::timestamp::DateTime;
+    using hlibs::facilities::timestamp::ParseTimestamp;
+
+    std::vector<std::string> texts;
+    const auto now = DateTime::Clock::now();
+    for (int i = 0; i != 1000; ++i) texts.push_back(DateTime(now + std::chrono::seconds(i * 7919)).timestamp());
+    std::vector<std::string_view> column(texts.begin(), texts.end());
+    std::vector<std::chrono::sys_seconds> moments(column.size());
+
+    BENCHMARK("std::get_time (the former way)") {
+        long long sum = 0;
+        for (const auto& text : texts) {
+            std::tm fields{};
+            std::istringstream ss(text);
+            ss >> std::get_time(&fields, "%Y-%m-%d %H:%M:%S");
+            sum += timegm(&fields);
+        }
+        return sum;
+    };
+
+    BENCHMARK("ParseTimestamp (column)") {
+        return ParseTimestamp(column, moments);
+    };
 }
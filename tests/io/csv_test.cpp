@@ -0,0 +1,170 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <cstdio>
+
+#include "../../sources/io/csv.hpp"
+#include "../../sources/io/helper_objects.hpp"
+
+
+TEST_CASE("CSVReader", "[libs][io][CSVReader]")
+{
+    using hlibs::io::CSVReader;
+
+    SECTION("is_default_constructible → false", "[type_traits]") {
+        REQUIRE(!std::is_default_constructible_v<CSVReader>);
+    }
+
+    SECTION("non-existing file → exception thrown", "[exceptions]") {
+        REQUIRE_THROWS_AS(CSVReader("./this-file-should-not-exist"), std::ios::failure);
+    }
+
+    SECTION("read quoted file → header skipped, fields unquoted", "[functional_requirements]") {
+        const std::filesystem::path path("../../inputs/csv-reader-1-read.csv");
+        std::vector<std::vector<std::string>> rows;
+
+        CSVReader reader(path);
+
+        while (reader.hasNextRow()) {
+            const auto& row = reader.getNextRow();
+            rows.emplace_back(row.begin(), row.end());
+        }
+
+        REQUIRE(reader.header() == std::vector<std::string>{"id", "name", "price", "comment"});
+        REQUIRE(reader.rows() == 5);
+        REQUIRE(rows.size() == 5);
+        REQUIRE(rows[1] == std::vector<std::string>{"2", "banana", "0.25", "yellow, ripe"});
+        REQUIRE(rows[2][3] == "say \"hi\"");
+        REQUIRE(rows[3] == std::vector<std::string>{"4", "dragon\nfruit", "12", ""});
+        REQUIRE_THAT(reader.toString(), Catch::Matchers::EndsWith("\"5\"}"));
+    }
+
+    SECTION("select columns by name → only projected fields in requested order", "[functional_requirements]") {
+        const std::filesystem::path path("../../inputs/csv-reader-1-read.csv");
+        std::vector<std::string> projected;
+
+        CSVReader reader(path);
+        reader.select(std::vector<std::string_view>{"comment", "id"});
+
+        while (reader.hasNextRow()) {
+            const auto& row = reader.getNextRow();
+            REQUIRE(row.size() == 2);
+            projected.emplace_back(std::string(row[0]) + '|' + std::string(row[1]));
+        }
+
+        REQUIRE(projected.front() == "fresh|1");
+        REQUIRE(projected.back() == "last|5");
+        REQUIRE_THROWS_AS(reader.select(std::vector<std::string_view>{"unknown"}), std::invalid_argument);
+    }
+
+    SECTION("CRLF, custom separator, tiny buffer, no header → all rows read", "[basic_check]") {
+        const std::filesystem::path path("../../inputs/csv-reader-2-crlf.csv");
+        std::string last;
+        long sum = 0;
+
+        CSVReader reader(path, ';', false, 4);
+
+        while (reader.hasNextRow()) {
+            const auto& row = reader.getNextRow();
+            last = row.back();
+            if (reader.rows() > 1) sum += std::stol(std::string(row[1]));
+        }
+
+        REQUIRE(reader.header().empty());
+        REQUIRE(reader.rows() == 4);
+        REQUIRE(last == "32");
+        REQUIRE(sum == 63);
+    }
+
+}
+
+TEST_CASE("CSVWriter", "[libs][io][CSVWriter]")
+{
+    using hlibs::io::CSVWriter;
+    using hlibs::io::CSVReader;
+    using hlibs::io::FileLoader;
+
+    SECTION("is_default_constructible → false", "[type_traits]") {
+        REQUIRE(!std::is_default_constructible_v<CSVWriter>);
+    }
+
+    SECTION("write mixed rows → expected content", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/csv-writer-1-write.csv");
+        const std::string expected = "id,value,note,ok\n7,0.5,\"a,b\",true\n-8,2.250,\"say \"\"hi\"\"\",false\n";
+
+        constexpr auto writeRows = [](const std::filesystem::path& p) {
+            CSVWriter writer(p);
+            writer.row("id", "value", "note", "ok");
+            writer.row(7, 0.5, "a,b", true);
+            writer.field(-8L);
+            writer.field(2.25, 3);
+            writer.field(std::string_view("say \"hi\""));
+            writer.field(false);
+            writer.endRow();
+            return writer.bytes();
+        };
+
+        constexpr auto getFileContent = [](const std::filesystem::path& p) {
+            FileLoader loader{p};
+            loader.read();
+            return std::string(loader.data().begin(), loader.data().end());
+        };
+
+        auto bytes = writeRows(path);
+        REQUIRE(bytes == expected.size());
+        REQUIRE_THAT(getFileContent(path), Catch::Matchers::Equals(expected));
+    }
+
+    SECTION("huge value in fixed notation with small buffer → all digits written", "[basic_check]") {
+        const std::filesystem::path path("../../outputs/csv-writer-3-huge-fixed.csv");
+
+        {
+            CSVWriter writer(path, ',', 16);
+            writer.field(1e300, 2);
+            writer.field(-1.5, 1);
+            writer.endRow();
+        }
+
+        FileLoader loader{path};
+        loader.read();
+        const std::string content(loader.data().begin(), loader.data().end());
+        std::string expected(400, '\0');
+        expected.resize(static_cast<std::size_t>(std::snprintf(expected.data(), expected.size(), "%.2f,-1.5\n", 1e300)));
+        REQUIRE(content == expected);
+    }
+
+    SECTION("write many rows with small buffer, read back → round trip", "[use_case]") {
+        const std::filesystem::path path("../../outputs/csv-writer-2-round-trip.csv");
+        constexpr int count = 1000;
+
+        {
+            CSVWriter writer(path, ',', 16);
+            writer.row("n", "half", "label");
+
+            for (int i = 0; i != count; ++i) {
+                writer.row(i, i / 2.0, "line\n" + std::to_string(i));
+            }
+
+            REQUIRE(writer.rows() == count + 1);
+        }
+
+        CSVReader reader(path);
+        double total = 0;
+        std::string label;
+
+        while (reader.hasNextRow()) {
+            const auto& row = reader.getNextRow();
+            total += std::stod(std::string(row[1]));
+            label = row[2];
+        }
+
+        REQUIRE(reader.rows() == count);
+        REQUIRE(total == 249750.0);
+        REQUIRE(label == "line\n999");
+    }
+
+}
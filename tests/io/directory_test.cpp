@@ -0,0 +1,102 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <filesystem>
+#include <string>
+#include <mutex>
+#include <set>
+
+#include "../../sources/io/directory.hpp"
+
+
+TEST_CASE("DirectoryScanner", "[libs][io][DirectoryScanner]")
+{
+    using hlibs::io::DirectoryScanner;
+    using hlibs::io::DirectoryEntry;
+    using hlibs::io::FileWriter;
+    using hlibs::io::GetFileSize;
+
+    const std::filesystem::path root("../../outputs/directory-scanner");
+    std::filesystem::remove_all(root);
+
+    for (auto branch = 0; branch != 5; ++branch) {
+        auto folder = root / ("branch-" + std::to_string(branch)) / "nested" / "deeper";
+        std::filesystem::create_directories(folder);
+
+        for (auto leaf = 0; leaf != 20; ++leaf) {
+            auto parent = leaf % 2 == 0 ? folder : folder.parent_path();
+            FileWriter writer(parent / ("file-" + std::to_string(leaf) + ".txt"));
+            writer.write(std::string(static_cast<std::size_t>(branch * 100 + leaf), 'x'));
+        }
+    }
+
+    std::filesystem::create_symlink("branch-0", root / "link-to-branch-0");
+
+    SECTION("not a directory → exception", "[exception]") {
+        const DirectoryScanner scanner(2);
+        REQUIRE_THROWS_AS(scanner.scan("../../inputs/get-file-size-1.txt"), std::invalid_argument);
+    }
+
+    SECTION("scan tree → the same totals as recursive_directory_iterator with GetFileSize", "[functional_requirements]") {
+        std::uint64_t bytes = 0;
+        std::uint64_t files = 0;
+        std::uint64_t directories = 0;
+
+        for (const auto& entry : std::filesystem::recursive_directory_iterator(root)) {
+            if (entry.is_symlink()) continue;
+            if (entry.is_directory()) ++directories;
+            if (!entry.is_regular_file()) continue;
+            bytes += static_cast<std::uint64_t>(GetFileSize(entry.path()));
+            ++files;
+        }
+
+        const DirectoryScanner scanner(4);
+        auto usage = scanner.scan(root);
+
+        REQUIRE(usage.bytes == bytes);
+        REQUIRE(usage.files == files);
+        REQUIRE(usage.files == 100);
+        REQUIRE(usage.directories == directories);
+        REQUIRE(usage.others == 1);
+        REQUIRE(usage.errors == 0);
+        REQUIRE_THAT(usage.toString(), Catch::Matchers::StartsWith("{\"" + std::to_string(bytes) + "\",\"100\","));
+    }
+
+    SECTION("scan with visitor → every entry streamed once with metadata", "[functional_requirements]") {
+        std::mutex mutex;
+        std::multiset<std::string> names;
+        std::size_t deepest = 0;
+        std::uint64_t sizes = 0;
+
+        const DirectoryScanner scanner(3);
+        auto usage = scanner.scan(root, [&](const DirectoryEntry& entry) {
+            std::scoped_lock lock(mutex);
+            names.emplace(entry.name);
+            deepest = std::max(deepest, entry.depth);
+            if (entry.type == std::filesystem::file_type::regular) sizes += entry.size;
+        });
+
+        REQUIRE(names.size() == usage.files + usage.directories + usage.others);
+        REQUIRE(names.count("nested") == 5);
+        REQUIRE(names.count("link-to-branch-0") == 1);
+        REQUIRE(deepest == 4);
+        REQUIRE(sizes == usage.bytes);
+        REQUIRE(usage.allocated == scanner.scan(root).allocated);
+    }
+
+    SECTION("visitor throwing in a worker → the exception rethrown by scan()", "[exception]") {
+        const DirectoryScanner scanner(4);
+        REQUIRE_THROWS_AS(scanner.scan(root, [](const DirectoryEntry& entry) {
+            if (entry.name == "file-7.txt") throw std::domain_error("visitor");
+        }), std::domain_error);
+    }
+
+    SECTION("single thread → the same totals as many threads", "[basic_check]") {
+        auto one = DirectoryScanner(1).scan(root);
+        auto many = DirectoryScanner(8).scan(root);
+        REQUIRE(one.toString() == many.toString());
+        REQUIRE(one.allocated == many.allocated);
+    }
+
+}
@@ -0,0 +1,237 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <filesystem>
+#include <string>
+#include <vector>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <atomic>
+#include <exception>
+
+#include "../../sources/io/follow.hpp"
+
+
+TEST_CASE("FileFollower", "[libs][io][FileFollower]")
+{
+    using hlibs::io::FileFollower;
+    using hlibs::io::FileWriter;
+    using namespace std::chrono_literals;
+
+    const std::filesystem::path path("../../outputs/file-follower-1.log");
+
+    {
+        FileWriter writer(path);
+        writer.write("old line\n");
+    }
+
+    SECTION("non-existing file → exception", "[exception]") {
+        REQUIRE_THROWS_AS(FileFollower("../../outputs/this-file-should-not-exist.log"), std::ios_base::failure);
+    }
+
+    SECTION("nothing appended → timeout without a line", "[basic_check]") {
+        FileFollower follower(path);
+        REQUIRE(!follower.getNextLine(20ms).has_value());
+    }
+
+    SECTION("follow from start → existing lines first", "[basic_check]") {
+        FileFollower follower(path, true);
+        REQUIRE(follower.getNextLine(1s) == "old line");
+    }
+
+    SECTION("append partial & complete lines → only complete lines returned", "[functional_requirements]") {
+        FileFollower follower(path);
+        FileWriter writer(path, std::ios::app);
+
+        writer.write("first ");
+        writer.sync();
+        REQUIRE(!follower.getNextLine(20ms).has_value());
+
+        writer.write("half\nsecond\n");
+        writer.sync();
+        REQUIRE(follower.getNextLine(1s) == "first half");
+        REQUIRE(follower.getNextLine(1s) == "second");
+        REQUIRE(follower.lines() == 2);
+    }
+
+    SECTION("line appended by another thread → woken up by inotify", "[functional_requirements]") {
+        FileFollower follower(path);
+
+        std::jthread producer([&path]() {
+            std::this_thread::sleep_for(50ms);
+            FileWriter writer(path, std::ios::app);
+            writer.write("from producer\n");
+        });
+
+        REQUIRE(follower.getNextLine(5s) == "from producer");
+    }
+
+    SECTION("truncate file → reading restarts from the beginning", "[functional_requirements]") {
+        FileFollower follower(path);
+        std::filesystem::resize_file(path, 0);
+        REQUIRE(!follower.getNextLine(20ms).has_value());
+
+        FileWriter writer(path, std::ios::app);
+        writer.write("after truncation\n");
+        writer.sync();
+
+        REQUIRE(follower.getNextLine(1s) == "after truncation");
+    }
+
+    SECTION("rotate file → rest of old file, then new file", "[functional_requirements]") {
+        const std::filesystem::path rotated("../../outputs/file-follower-1.log.1");
+        FileFollower follower(path);
+
+        {
+            FileWriter writer(path, std::ios::app);
+            writer.write("last of old\n");
+        }
+
+        std::filesystem::rename(path, rotated);
+
+        {
+            FileWriter writer(path);
+            writer.write("first of new\n");
+        }
+
+        REQUIRE(follower.getNextLine(1s) == "last of old");
+        REQUIRE(follower.getNextLine(1s) == "first of new");
+        REQUIRE_THAT(follower.toString(), Catch::Matchers::EndsWith("\"2\"}"));
+    }
+
+}
+
+TEST_CASE("FollowGroup", "[libs][io][FollowGroup]")
+{
+    using hlibs::io::FollowGroup;
+    using hlibs::io::FileWriter;
+    using namespace std::chrono_literals;
+
+    SECTION("follow two files → lines of both on one thread", "[functional_requirements]") {
+        const std::filesystem::path first("../../outputs/follow-group-1.log");
+        const std::filesystem::path second("../../outputs/follow-group-2.log");
+        std::mutex mutex;
+        std::vector<std::string> received;
+
+        FileWriter a(first);
+        FileWriter b(second);
+        a.write("already there\n");
+        a.sync();
+
+        FollowGroup group([&](const std::filesystem::path& p, std::string_view line) {
+            std::scoped_lock lock(mutex);
+            received.push_back(p.filename().string() + ':' + std::string(line));
+        });
+
+        group.follow(first, true);
+        group.follow(second);
+
+        for (auto i = 0; i != 3; ++i) {
+            a.write("a" + std::to_string(i) + '\n');
+            b.write("b" + std::to_string(i) + '\n');
+            a.sync();
+            b.sync();
+        }
+
+        for (auto waited = 0; waited != 500 && group.lines() < 7; ++waited) {
+            std::this_thread::sleep_for(10ms);
+        }
+
+        std::scoped_lock lock(mutex);
+        REQUIRE(received.size() == 7);
+        REQUIRE(received.front() == "follow-group-1.log:already there");
+        REQUIRE(std::ranges::count(received, std::string("follow-group-2.log:b2")) == 1);
+        REQUIRE_THAT(group.toString(), Catch::Matchers::Equals("{\"2\",\"7\"}"));
+    }
+
+    SECTION("callback calling follow() and toString(), then throwing → no deadlock, exception kept", "[multithreading]") {
+        const std::filesystem::path first("../../outputs/follow-group-3.log");
+        const std::filesystem::path second("../../outputs/follow-group-4.log");
+        FileWriter a(first);
+        FileWriter b(second);
+        b.write("from the second file\n");
+        b.sync();
+        std::atomic<bool> followed = false;
+
+        FollowGroup* self = nullptr;
+        FollowGroup group([&](const std::filesystem::path&, std::string_view line) {
+            if (!followed.exchange(true)) self->follow(second, true);
+            if (self->toString().empty()) return;
+            if (line == "throw") throw std::domain_error("callback");
+        });
+        self = &group;
+
+        group.follow(first);
+        a.write("first\nthrow\nafter\n");
+        a.sync();
+
+        for (auto waited = 0; waited != 500 && group.lines() < 4; ++waited) {
+            std::this_thread::sleep_for(10ms);
+        }
+
+        REQUIRE(group.lines() == 4);
+        REQUIRE_THROWS_AS(std::rethrow_exception(group.error()), std::domain_error);
+    }
+
+}
+
+TEST_CASE("FollowedFile", "[libs][io][FollowedFile]")
+{
+    using hlibs::io::FollowedFile;
+    using hlibs::io::Watches;
+    using hlibs::io::FileWriter;
+
+    SECTION("queue overflow after an unseen rotation → rest of old file, then new file", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/followed-file-1.log");
+        const std::filesystem::path rotated("../../outputs/followed-file-1.log.1");
+        std::vector<std::string> lines;
+        auto push = [&lines](std::string_view line) { lines.emplace_back(line); };
+
+        FileWriter(path).write("");
+        Watches watches;
+        FollowedFile file(path, watches, false);
+
+        {
+            FileWriter writer(path, std::ios::app);
+            writer.write("last of old\n");
+        }
+
+        std::filesystem::rename(path, rotated);
+        FileWriter(path).write("first of new\n");
+
+        inotify_event overflow{};
+        overflow.wd = -1;
+        overflow.mask = IN_Q_OVERFLOW;
+        file.handle(overflow, push);
+
+        REQUIRE(lines == std::vector<std::string>{"last of old", "first of new"});
+    }
+
+}
+
+TEST_CASE("Watches", "[libs][io][Watches]")
+{
+    using hlibs::io::Watches;
+    using hlibs::io::FileWriter;
+
+    SECTION("folder watched twice, released once → still watched", "[functional_requirements]") {
+        const std::filesystem::path folder("../../outputs/watches");
+        std::filesystem::create_directories(folder);
+        Watches watches;
+
+        auto first = watches.add(folder, IN_CREATE);
+        auto second = watches.add(folder, IN_CREATE);
+        REQUIRE(first == second);
+
+        watches.remove(first);
+        std::filesystem::remove(folder / "created.txt");
+        FileWriter writer(folder / "created.txt");
+
+        pollfd waiting{watches.get(), POLLIN, 0};
+        REQUIRE(::poll(&waiting, 1, 1000) == 1);
+        watches.remove(second);
+    }
+
+}
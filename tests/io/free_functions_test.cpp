@@ -1,6 +1,10 @@
 #include <catch2/catch_test_macros.hpp>
 
 #include <filesystem>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <array>
 
 #include "../../sources/io/free_functions.hpp"
 
@@ -34,3 +38,84 @@ TEST_CASE("GetFileSize()", "[libs][io][GetFileSize]")
     }
 
 }
+
+TEST_CASE("TransferFile()", "[libs][io][TransferFile]")
+{
+    using hlibs::io::TransferFile;
+    using hlibs::io::CopyBytes;
+    using hlibs::io::GetFileSize;
+
+    constexpr auto getFileContent = [](const std::filesystem::path& p) {
+        std::ifstream file(p, std::ios::binary);
+        return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    };
+
+    SECTION("range at offsets, small steps → exact bytes, target kept around, progress to the end", "[functional_requirements]") {
+        const std::filesystem::path source("../../inputs/get-file-size-1.txt");
+        const std::filesystem::path target("../../outputs/transfer-file-1-range.txt");
+        const auto content = getFileContent(source);
+        std::vector<std::size_t> steps;
+
+        std::ofstream(target, std::ios::trunc) << std::string(10, '-');
+        auto copied = TransferFile(source, target, 100, 4, 1000, [&steps](std::size_t done, std::size_t count) {
+            REQUIRE(count == 1000);
+            steps.push_back(done);
+        });
+
+        auto result = getFileContent(target);
+        REQUIRE(copied == 1000);
+        REQUIRE(result == "----" + content.substr(100, 1000));
+        REQUIRE(!steps.empty());
+        REQUIRE(steps.back() == 1000);
+
+        REQUIRE(TransferFile(source, target, GetFileSize(source) - 5, 0) == 5);
+        REQUIRE(TransferFile(source, target, GetFileSize(source) + 5, 0) == 0);
+    }
+
+    SECTION("pipe to file at offset, file to pipe → buffered and sendfile fallbacks", "[basic_check]") {
+        const std::filesystem::path path("../../outputs/transfer-file-2-pipes.txt");
+        const std::string text = "through the pipe";
+        std::array<int, 2> pipe_ends{};
+        REQUIRE(::pipe(pipe_ends.data()) == 0);
+
+        REQUIRE(::write(pipe_ends[1], text.data(), text.size()) == static_cast<ssize_t>(text.size()));
+        int out = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        off_t out_offset = 2;
+        REQUIRE(CopyBytes(pipe_ends[0], nullptr, out, &out_offset, text.size(), {}, 4) == text.size());
+        REQUIRE(out_offset == static_cast<off_t>(2 + text.size()));
+        ::close(out);
+
+        int in = ::open(path.c_str(), O_RDONLY);
+        off_t in_offset = 2;
+        std::string echoed(text.size(), '\0');
+        REQUIRE(CopyBytes(in, &in_offset, pipe_ends[1], nullptr, text.size()) == text.size());
+        REQUIRE(::read(pipe_ends[0], echoed.data(), echoed.size()) == static_cast<ssize_t>(text.size()));
+        ::close(in);
+        ::close(pipe_ends[0]);
+        ::close(pipe_ends[1]);
+
+        REQUIRE(echoed == text);
+        REQUIRE(getFileContent(path) == std::string(2, '\0') + text);
+    }
+
+    SECTION("target opened for appending, closed source → appended by sendfile, bad descriptor reported", "[basic_check]") {
+        const std::filesystem::path source("../../inputs/get-file-size-1.txt");
+        const std::filesystem::path path("../../outputs/transfer-file-3-append.txt");
+        const auto content = getFileContent(source);
+
+        std::ofstream(path, std::ios::trunc) << "head:";
+        int in = ::open(source.c_str(), O_RDONLY);
+        int out = ::open(path.c_str(), O_WRONLY | O_APPEND);
+        off_t in_offset = 0;
+        REQUIRE(CopyBytes(in, &in_offset, out, nullptr, 50) == 50);
+        REQUIRE(in_offset == 50);
+
+        ::close(in);
+        off_t closed_offset = 0;
+        REQUIRE_THROWS_AS(CopyBytes(in, &closed_offset, out, nullptr, 50), std::ios_base::failure);
+        ::close(out);
+
+        REQUIRE(getFileContent(path) == "head:" + content.substr(0, 50));
+    }
+
+}
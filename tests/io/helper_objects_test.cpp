@@ -6,6 +6,12 @@
 #include <filesystem>
 #include <cassert>
 #include <array>
+#include <thread>
+#include <vector>
+#include <tuple>
+#include <limits>
+#include <iomanip>
+#include <sstream>
 
 #include "../../sources/io/helper_objects.hpp"
 
@@ -75,6 +81,60 @@ TEST_CASE("StreamToFile", "[libs][io][StreamToFile]")
         REQUIRE_THAT(repr, Catch::Matchers::EndsWith("}"));
     }
 
+    SECTION("small buffer and background flushing → all output in order", "[functional_requirements]") {
+        const std::string file1("../../outputs/stream-to-file-5-small-buffer.txt");
+        const std::string file2("../../outputs/stream-to-file-5-background.txt");
+        std::string expected;
+        for (int i = 0; i != 1000; ++i) expected += "line " + std::to_string(i) + '\n';
+
+        constexpr auto redirect = [](const std::string& path, std::size_t capacity, std::chrono::milliseconds interval) {
+            StreamToFile wrapper(std::cout, path, capacity, interval);
+            for (int i = 0; i != 1000; ++i) std::cout << "line " << i << '\n';
+        };
+
+        constexpr auto getFileContent = [](const std::string& path) {
+            hlibs::io::FileLoader loader{path};
+            loader.read();
+            return std::string(loader.data().begin(), loader.data().end());
+        };
+
+        redirect(file1, 7, {});
+        redirect(file2, 64, std::chrono::milliseconds(1));
+        REQUIRE(getFileContent(file1) == expected);
+        REQUIRE(getFileContent(file2) == expected);
+    }
+
+    SECTION("background flushing, producer pauses → buffered output in the file after the interval", "[functional_requirements]") {
+        const std::string path("../../outputs/stream-to-file-6-pause.txt");
+        StreamToFile wrapper(std::cout, path, 1024, std::chrono::milliseconds(10));
+        std::cout << "before the pause " << 42 << '\n';
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (GetFileSize(path) != 20 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        REQUIRE(GetFileSize(path) == 20);
+    }
+
+    SECTION("capture in memory → output kept, original buffer restored", "[functional_requirements]") {
+        std::ostringstream stream;
+        stream << "before|";
+
+        {
+            auto capture = StreamToFile::Capture(stream, 4);
+            stream << "captured " << 42 << ' ' << std::string(100, 'x') << std::flush;
+            REQUIRE(capture.captured() == "captured 42 " + std::string(100, 'x'));
+
+            capture.clear();
+            stream << "again";
+            REQUIRE(capture.captured() == "again");
+        }
+
+        stream << "after";
+        REQUIRE(stream.str() == "before|after");
+    }
+
 }
 
 TEST_CASE("FileLoader", "[libs][io][FileLoader]")
@@ -202,6 +262,108 @@ TEST_CASE("FileReader", "[libs][io][FileReader]")
         REQUIRE(linesRead == 21UL);
     }
 
+    SECTION("scan lines for keywords → line numbers and positions of matches", "[use_case]") {
+        const std::filesystem::path path("../../outputs/file-reader-3-scan.txt");
+        const hlibs::facilities::strings::Keywords keywords({"error", "timeout", "disk full"}, true);
+        std::vector<std::tuple<std::size_t, std::string, std::size_t>> found;
+
+        {
+            hlibs::io::FileWriter writer(path);
+            writer.write("info: started\nERROR: disk full\nwarning: slow\nerror after Timeout\n");
+        }
+
+        FileReader reader(path);
+        reader.getNextLine();
+        auto matching = reader.scan(keywords, [&found](std::size_t line_no, std::string_view line, const auto& match) {
+            found.emplace_back(line_no, std::string(line.substr(match.position, 4)), match.pattern);
+        });
+
+        REQUIRE(matching == 2);
+        REQUIRE(reader.lines() == 4);
+        REQUIRE(found == std::vector<std::tuple<std::size_t, std::string, std::size_t>>{{2, "ERRO", 0}, {2, "disk", 2}, {4, "erro", 0}, {4, "Time", 1}});
+    }
+
+}
+
+TEST_CASE("PositionalReader", "[libs][io][PositionalReader]")
+{
+    using hlibs::io::PositionalReader;
+    using hlibs::io::FileLoader;
+
+    const std::filesystem::path path("../../inputs/get-file-size-1.txt");
+
+    constexpr auto getFileContent = [](const std::filesystem::path& p) {
+        FileLoader loader{p};
+        loader.read();
+        return std::string(loader.data().begin(), loader.data().end());
+    };
+
+    SECTION("is_default_constructible → false", "[type_traits]") {
+        REQUIRE(!std::is_default_constructible_v<PositionalReader>);
+    }
+
+    SECTION("non-existing file → exception thrown", "[exceptions]") {
+        REQUIRE_THROWS_AS(PositionalReader("./this-file-should-not-exist"), std::ios_base::failure);
+    }
+
+    SECTION("reads across blocks and past the end → the same bytes as the file", "[functional_requirements]") {
+        const auto content = getFileContent(path);
+        PositionalReader reader(path, 100, 1000, 2);
+
+        REQUIRE(reader.size() == content.size());
+        REQUIRE(reader.capacity() == 10);
+        REQUIRE(reader.read(0, 10) == content.substr(0, 10));
+        REQUIRE(reader.read(95, 310) == content.substr(95, 310));
+        REQUIRE(reader.read(content.size() - 7, 100) == content.substr(content.size() - 7));
+        REQUIRE(reader.read(content.size() + 1, 100).empty());
+    }
+
+    SECTION("repeated and scattered reads → hits, misses and evictions counted", "[functional_requirements]") {
+        PositionalReader reader(path, 64, 4 * 64, 1);
+
+        reader.read(0, 10);
+        reader.read(10, 10);
+        REQUIRE(reader.stats().misses == 1);
+        REQUIRE(reader.stats().hits == 1);
+
+        for (std::size_t i = 1; i != 5; ++i) reader.read(i * 64, 1);
+        auto [hits, misses, evictions] = reader.stats();
+        REQUIRE(misses == 5);
+        REQUIRE(evictions == 1);
+
+        reader.read(4 * 64, 1);
+        REQUIRE(reader.stats().hits == hits + 1);
+        reader.read(0, 1);
+        REQUIRE(reader.stats().misses == misses + 1);
+    }
+
+    SECTION("many threads at random offsets → every read matches the file", "[use_case]") {
+        const auto content = getFileContent(path);
+        PositionalReader reader(path, 128, 8 * 128, 4);
+        std::atomic<std::size_t> mismatches = 0;
+
+        {
+            std::vector<std::jthread> threads;
+            for (std::size_t t = 0; t != 8; ++t) {
+                threads.emplace_back([&, t] {
+                    std::size_t state = t + 1;
+                    for (int i = 0; i != 2000; ++i) {
+                        state = state * 6364136223846793005ULL + 1442695040888963407ULL;
+                        auto offset = (state >> 33) % content.size();
+                        auto count = (state >> 20) % 300;
+                        if (reader.read(offset, count) != content.substr(offset, count)) ++mismatches;
+                    }
+                });
+            }
+        }
+
+        auto [hits, misses, evictions] = reader.stats();
+        REQUIRE(mismatches == 0);
+        REQUIRE(hits + misses >= 16000);
+        REQUIRE(evictions > 0);
+        REQUIRE_THAT(reader.toString(), Catch::Matchers::StartsWith("{\"../../inputs/get-file-size-1.txt\",\"5805\""));
+    }
+
 }
 
 TEST_CASE("FileWriter", "[libs][io][FileWriter]")
@@ -210,6 +372,12 @@ TEST_CASE("FileWriter", "[libs][io][FileWriter]")
     using hlibs::io::GetFileSize;
     using hlibs::io::FileLoader;
 
+    constexpr auto getFileContent = [](const std::filesystem::path& p) {
+        FileLoader loader{p};
+        loader.read();
+        return std::string(loader.data().begin(), loader.data().end());
+    };
+
     SECTION("is_standard_layout → false", "[type_traits]") {
         REQUIRE(!std::is_standard_layout_v<FileWriter>);
     }
@@ -304,6 +472,61 @@ TEST_CASE("FileWriter", "[libs][io][FileWriter]")
         REQUIRE(written == expected);
     }
 
+    SECTION("octal with showbase, internal → padding before the leading zero, as std::ostream", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-16-octal.txt");
+        const auto flags = std::ios::oct | std::ios::showbase | std::ios::internal;
+
+        {
+            FileWriter writer(path);
+            writer.integer(501, flags, 10);
+        }
+
+        std::ostringstream ss;
+        ss.flags(flags);
+        ss << std::setw(10) << 501;
+        REQUIRE(ss.str() == "      0765");
+        REQUIRE(getFileContent(path) == ss.str());
+    }
+
+    SECTION("hexfloat, internal → padding after the sign, else after 0x, as std::ostream", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-17-hexfloat.txt");
+        const auto flags = std::ios::fixed | std::ios::scientific | std::ios::internal;
+
+        {
+            FileWriter writer(path);
+            writer.floating(-0.0, 6, flags, 9);
+            writer.write("|");
+            writer.floating(1.5, 6, flags, 10);
+        }
+
+        std::ostringstream ss;
+        ss.flags(flags);
+        ss << std::setw(9) << -0.0 << '|' << std::setw(10) << 1.5;
+        REQUIRE(ss.str() == "-  0x0p+0|0x  1.8p+0");
+        REQUIRE(getFileContent(path) == ss.str());
+    }
+
+    SECTION("fixed with uppercase → nan and inf in lower case, as std::ostream", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-18-fixed-upper.txt");
+        const auto flags = std::ios::fixed | std::ios::uppercase;
+
+        {
+            FileWriter writer(path);
+            writer.floating(std::numeric_limits<double>::quiet_NaN(), 2, flags);
+            writer.write("|");
+            writer.floating(-std::numeric_limits<double>::infinity(), 2, flags);
+            writer.write("|");
+            writer.floating(1.25, 2, std::ios::scientific | std::ios::uppercase);
+        }
+
+        std::ostringstream ss;
+        ss.flags(flags);
+        ss.precision(2);
+        ss << std::numeric_limits<double>::quiet_NaN() << '|' << -std::numeric_limits<double>::infinity() << '|' << std::scientific << 1.25;
+        REQUIRE(getFileContent(path) == ss.str());
+        REQUIRE(ss.str() == "nan|-inf|1.25E+00");
+    }
+
     SECTION("write integers → expected number of bytes written", "[functional_requirements]") {
         const std::filesystem::path path("../../outputs/file-writer-5-integers.txt");
         const std::size_t expected = 40UL;
@@ -444,4 +667,203 @@ TEST_CASE("FileWriter", "[libs][io][FileWriter]")
         REQUIRE(bytes == expected);
     }
 
+    SECTION("write spans of numbers in batch → the same content as one by one", "[functional_requirements]") {
+        const std::filesystem::path batchPath("../../outputs/file-writer-11-batch.txt");
+        const std::filesystem::path singlePath("../../outputs/file-writer-12-single.txt");
+        const std::vector<long> integers = {-3, 0, 17, 255, 65536, -1000000};
+        const std::array<double, 5> floats = {-0.5, 0.0, 3.14159, 1e-3, 739528.046};
+
+        FileWriter batch(batchPath);
+        batch.integers(std::span(integers), ", ", std::ios::hex | std::ios::showbase, 10);
+        batch.newline();
+        batch.floatings(std::span(floats), ";", 3, std::ios::scientific);
+        batch.sync();
+
+        FileWriter single(singlePath);
+
+        for (std::size_t i = 0; i != integers.size(); ++i) {
+            if (i != 0) single.write(", ");
+            single.integer(integers[i], std::ios::hex | std::ios::showbase, 10);
+        }
+
+        single.newline();
+
+        for (std::size_t i = 0; i != floats.size(); ++i) {
+            if (i != 0) single.write(";");
+            single.floating(floats[i], 3, std::ios::scientific);
+        }
+
+        single.sync();
+
+        REQUIRE(batch.bytes() == single.bytes());
+        REQUIRE(getFileContent(batchPath) == getFileContent(singlePath));
+        REQUIRE_THAT(getFileContent(batchPath), Catch::Matchers::EndsWith("-5.000e-01;0.000e+00;3.142e+00;1.000e-03;7.395e+05"));
+    }
+
+    SECTION("gather small and large records between writes → exact bytes and order", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-13-gather.txt");
+        const std::string blob(FileWriter::gather_threshold + 3, '#');
+
+        FileWriter writer(path);
+        writer.write("head|");
+        writer.gather({"<", "small", ">", "\n"});
+        writer.gather({"[", blob, "]", "\n"});
+        writer.write("tail");
+        writer.sync();
+
+        const std::string expected = "head|<small>\n[" + blob + "]\ntail";
+        REQUIRE(writer.bytes() == expected.size());
+        REQUIRE(writer.position() == std::fstream::pos_type(expected.size()));
+        REQUIRE(getFileContent(path) == expected);
+    }
+
+    SECTION("gather large record in append mode → appended after existing content", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-14-gather-append.txt");
+        const std::string blob(FileWriter::gather_threshold, 'x');
+
+        {
+            FileWriter writer(path);
+            writer.write("first\n");
+        }
+
+        FileWriter writer(path, std::ios::app);
+        writer.gather({blob, "\n"});
+        writer.write("last");
+        writer.sync();
+
+        REQUIRE(writer.bytes() == blob.size() + 5);
+        REQUIRE(GetFileSize(path) == static_cast<long>(6 + blob.size() + 5));
+    }
+
+    SECTION("file renamed before a large gather → written into the renamed file", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-19-gather-rename.txt");
+        const std::filesystem::path renamed("../../outputs/file-writer-19-gather-renamed.txt");
+        const std::string blob(FileWriter::gather_threshold, '#');
+        std::filesystem::remove(renamed);
+
+        {
+            FileWriter writer(path);
+            writer.write("head|");
+            std::filesystem::rename(path, renamed);
+            writer.gather({blob, "\n"});
+            writer.write("tail");
+        }
+
+        REQUIRE(!std::filesystem::exists(path));
+        REQUIRE(getFileContent(renamed) == "head|" + blob + "\ntail");
+    }
+
+    SECTION("transfer ranges of files between writes → exact bytes and order", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-15-transfer-range.txt");
+        const std::filesystem::path source("../../inputs/get-file-size-1.txt");
+        std::size_t reported = 0;
+
+        const auto content = getFileContent(source);
+
+        {
+            FileWriter writer(path);
+            writer.write("<");
+            writer.transfer(source, 10, 20);
+            writer.write("|");
+            writer.transfer(source, static_cast<off_t>(content.size() - 3), 100, [&reported](std::size_t done, std::size_t) { reported = done; });
+            writer.write(">");
+            REQUIRE(writer.bytes() == 26);
+        }
+
+        REQUIRE(reported == 3);
+        REQUIRE(getFileContent(path) == "<" + content.substr(10, 20) + "|" + content.substr(content.size() - 3) + ">");
+    }
+
+}
+
+TEST_CASE("FileWriterBuffered", "[libs][io][FileWriterBuffered]")
+{
+    using hlibs::io::FileWriterBuffered;
+    using hlibs::io::GetFileSize;
+
+    SECTION("is_default_constructible → false", "[type_traits]") {
+        REQUIRE(!std::is_default_constructible_v<FileWriterBuffered>);
+    }
+
+    SECTION("wrong open mode → exception", "[exception]") {
+        const std::filesystem::path path("../../outputs/file-writer-buffered-1-mode.txt");
+        REQUIRE_THROWS(FileWriterBuffered(path, 64, {}, false, std::ios::in));
+    }
+
+    SECTION("write below capacity → nothing flushed until sync", "[basic_check]") {
+        const std::filesystem::path path("../../outputs/file-writer-buffered-2-sync.txt");
+
+        FileWriterBuffered writer(path, 64);
+        writer.write("0123456789");
+        writer.put('\n');
+
+        REQUIRE(writer.flushes() == 0);
+        REQUIRE(GetFileSize(path) == 0);
+        writer.sync();
+        REQUIRE(writer.flushes() == 1);
+        REQUIRE(GetFileSize(path) == 11);
+        REQUIRE(writer.bytesPerFlush() == 11);
+    }
+
+    SECTION("flush every 10 messages → expected counters", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-buffered-3-messages.txt");
+
+        constexpr auto writeMessages = [](const std::filesystem::path& p) {
+            FileWriterBuffered writer(p, 1024, {.messages = 10});
+
+            for (auto i = 0; i != 100; ++i) {
+                writer.write("message\n");
+            }
+
+            return std::make_pair(writer.flushes(), writer.bytesPerFlush());
+        };
+
+        auto [flushes, bytesPerFlush] = writeMessages(path);
+        REQUIRE(flushes == 10);
+        REQUIRE(bytesPerFlush == 80);
+        REQUIRE(GetFileSize(path) == 800);
+    }
+
+    SECTION("write on background thread, bytes policy → whole content in order", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-buffered-4-thread.txt");
+        std::string expected;
+
+        constexpr auto writeLines = [](const std::filesystem::path& p, std::string& copy) {
+            FileWriterBuffered writer(p, 256, {.bytes = 200}, true);
+
+            for (auto i = 0; i != 5000; ++i) {
+                auto line = std::to_string(i) + '\n';
+                copy += line;
+                writer.write(line);
+            }
+
+            writer.write(std::string(1000, '#'));
+            copy += std::string(1000, '#');
+            return writer.toString();
+        };
+
+        auto repr = writeLines(path, expected);
+
+        hlibs::io::FileLoader loader{path};
+        loader.read();
+        REQUIRE(std::string(loader.data().begin(), loader.data().end()) == expected);
+        REQUIRE_THAT(repr, Catch::Matchers::ContainsSubstring(std::to_string(expected.size())));
+    }
+
+    SECTION("one message then idle, interval policy on thread → flushed without further writes", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/file-writer-buffered-5-idle.txt");
+
+        FileWriterBuffered writer(path, 1024, {.interval = std::chrono::milliseconds(20)}, true);
+        writer.write("lonely message\n");
+        REQUIRE(GetFileSize(path) == 0);
+
+        const auto deadline = std::chrono::steady_clock::now() + std::chrono::seconds(5);
+        while (GetFileSize(path) != 15 && std::chrono::steady_clock::now() < deadline) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        }
+
+        REQUIRE(GetFileSize(path) == 15);
+        REQUIRE(writer.flushes() == 1);
+    }
+
 }
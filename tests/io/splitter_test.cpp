@@ -0,0 +1,193 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <filesystem>
+#include <string>
+#include <set>
+#include <sys/stat.h>
+
+#include "../../sources/io/splitter.hpp"
+
+
+TEST_CASE("SplitterWriter", "[libs][io][SplitterWriter]")
+{
+    using hlibs::io::SplitterWriter;
+    using hlibs::io::SplitterScheme;
+    using hlibs::io::FileReader;
+    using hlibs::io::GetFileSize;
+
+    SECTION("naming scheme → {$prefix}${name}{$suffix}_{$file_no}.{$ext}", "[basic_check]") {
+        const SplitterScheme scheme{"../../outputs", "log_", "LIBS", "", "txt"};
+        REQUIRE(scheme.at(1) == std::filesystem::path("../../outputs/log_LIBS_1.txt"));
+    }
+
+    SECTION("non-existing folder → exception", "[exception]") {
+        const SplitterScheme scheme{"./this-folder-should-not-exist/", "", "split", "", "txt"};
+        REQUIRE_THROWS_AS(SplitterWriter(scheme, 2), std::invalid_argument);
+    }
+
+    SECTION("round-robin with size limit → rolled files with all the bytes", "[functional_requirements]") {
+        const SplitterScheme scheme{"../../outputs", "splitter-writer-", "1", "-rr", "txt"};
+        const std::string record = "0123456789abcdef\n";    // 17 bytes
+        constexpr std::size_t count = 300;
+
+        constexpr auto split = [](const SplitterScheme& s, const std::string& r) {
+            SplitterWriter writer(s, 3, 1000, 128);
+
+            for (std::size_t i = 0; i != count; ++i) {
+                writer.write(r);
+            }
+
+            writer.sync();
+            return std::make_pair(writer.paths(), writer.bytes());
+        };
+
+        auto [paths, bytes] = split(scheme, record);
+        long total = 0;
+
+        for (const auto& path : paths) {
+            auto size = GetFileSize(path);
+            REQUIRE(size <= 1000);
+            REQUIRE(size % 17 == 0);
+            total += size;
+        }
+
+        REQUIRE(bytes == count * record.size());
+        REQUIRE(total == static_cast<long>(bytes));
+        REQUIRE(paths.size() == 6);
+        REQUIRE(paths.back() == scheme.at(6));
+    }
+
+    SECTION("rolled and closed files → no blocks kept reserved past their ends", "[memory]") {
+        const SplitterScheme scheme{"../../outputs", "splitter-writer-", "3", "-reserved", "txt"};
+        const std::string record(1UL << 20, 'r');
+
+        {
+            SplitterWriter writer(scheme, 1, 1UL << 22, 1UL << 16);
+            for (int i = 0; i != 5; ++i) writer.write(record);
+        }
+
+        for (std::size_t file_no : {1, 2}) {
+            struct stat stat_buffer{};
+            REQUIRE(::stat(scheme.at(file_no).c_str(), &stat_buffer) == 0);
+            REQUIRE(stat_buffer.st_size == (file_no == 1 ? 4 : 1) * static_cast<off_t>(record.size()));
+            REQUIRE(stat_buffer.st_blocks * 512 <= stat_buffer.st_size + (1L << 16));
+        }
+    }
+
+    SECTION("hash-partitioned by key → each key in a single file", "[functional_requirements]") {
+        const SplitterScheme scheme{"../../outputs", "splitter-writer-", "2", "-hash", "csv"};
+        const std::array<std::string, 4> keys = {"alpha", "beta", "gamma", "delta"};
+
+        {
+            SplitterWriter writer(scheme, 4);
+
+            for (auto i = 0; i != 400; ++i) {
+                const auto& key = keys[i % keys.size()];
+                writer.write(key, key + ',' + std::to_string(i) + '\n');
+            }
+        }
+
+        std::size_t lines = 0;
+        std::multiset<std::string> placements;
+
+        for (auto file_no = 1; file_no <= 4; ++file_no) {
+            FileReader reader(scheme.at(file_no));
+            std::set<std::string> found;
+
+            while (reader.hasNextLine()) {
+                auto line = reader.getNextLine();
+                if (line.empty()) continue;
+                found.insert(line.substr(0, line.find(',')));
+                ++lines;
+            }
+
+            placements.insert(found.begin(), found.end());
+        }
+
+        for (const auto& key : keys) {
+            REQUIRE(placements.count(key) == 1);
+        }
+
+        REQUIRE(lines == 400);
+    }
+
+}
+
+TEST_CASE("SplitterReader", "[libs][io][SplitterReader]")
+{
+    using hlibs::io::SplitterReader;
+    using hlibs::io::SplitterScheme;
+    using hlibs::io::FileWriter;
+    using hlibs::io::FileLoader;
+
+    const SplitterScheme scheme{"../../outputs", "splitter-reader-", "segment", "", "log"};
+    std::string expected;
+
+    for (auto file_no = 1; file_no <= 3; ++file_no) {
+        FileWriter writer(scheme.at(file_no));
+
+        for (auto i = 0; i != 100 * file_no; ++i) {
+            auto line = "segment " + std::to_string(file_no) + " line " + std::to_string(i) + '\n';
+            writer.write(line);
+            expected += line;
+        }
+    }
+
+    const std::vector<std::filesystem::path> segments = {scheme.at(1), scheme.at(2), scheme.at(3)};
+
+    SECTION("missing segment → exception", "[exception]") {
+        REQUIRE_THROWS_AS(SplitterReader({scheme.at(1), "./this-file-should-not-exist"}), std::ios::failure);
+    }
+
+    SECTION("read lines with small chunks → all lines of all segments in order", "[functional_requirements]") {
+        SplitterReader reader(segments, 64, 2);
+        std::string joined;
+
+        while (reader.hasNextLine()) {
+            joined += reader.getNextLine() + '\n';
+        }
+
+        REQUIRE(reader.lines() == 600);
+        REQUIRE(joined == expected);
+        REQUIRE_THAT(reader.toString(), Catch::Matchers::Equals("{\"3\",\"600\"}"));
+    }
+
+    SECTION("read bytes → the concatenation of segments", "[functional_requirements]") {
+        SplitterReader reader(segments, 1000);
+        std::string joined;
+        std::array<char, 333> buffer{};
+
+        while (auto n = reader.read(buffer)) {
+            joined.append(buffer.data(), n);
+        }
+
+        REQUIRE(joined == expected);
+        REQUIRE(!reader.hasNextLine());
+    }
+
+    SECTION("copy whole sequence to writer → single rebuilt file", "[use_case]") {
+        const std::filesystem::path path("../../outputs/splitter-reader-rebuilt.log");
+        std::size_t copied = 0;
+
+        {
+            FileWriter writer(path);
+            writer.write("# rebuilt\n");
+            SplitterReader reader(segments);
+            copied = reader.copyTo(writer);
+            writer.write("# end\n");
+            REQUIRE(writer.bytes() == 16 + expected.size());
+
+            SplitterReader started(segments);
+            started.getNextLine();
+            REQUIRE_THROWS_AS(started.copyTo(writer), std::logic_error);
+        }
+
+        FileLoader loader(path);
+        loader.read();
+        REQUIRE(copied == expected.size());
+        REQUIRE(std::string(loader.data().begin(), loader.data().end()) == "# rebuilt\n" + expected + "# end\n");
+    }
+
+}
@@ -0,0 +1,150 @@
+#include <catch2/catch_test_macros.hpp>
+#include <catch2/matchers/catch_matchers.hpp>
+#include <catch2/matchers/catch_matchers_string.hpp>
+
+#include <filesystem>
+#include <string>
+#include <fstream>
+#include <vector>
+#include <random>
+
+#include "../../sources/standard/compression.hpp"
+#include "../../sources/io/helper_objects.hpp"
+
+
+TEST_CASE("Block", "[libs][standard][compression][Block]")
+{
+    using hlibs::standard::compression::Block;
+    using hlibs::standard::compression::CompressBound;
+
+    constexpr auto roundTrip = [](const std::string& text) {
+        std::vector<char> packed(CompressBound(text.size()));
+        auto size = Block::Compress(text, packed);
+        std::string unpacked(text.size(), '\0');
+        auto raw = Block::Decompress(std::span<const char>(packed.data(), size), unpacked);
+        return std::make_pair(size, unpacked.substr(0, raw));
+    };
+
+    SECTION("empty, short and incompressible input → round trip", "[basic_check]") {
+        std::mt19937 engine(7);
+        std::string noise(5000, '\0');
+        for (auto& ch : noise) ch = static_cast<char>(engine());
+
+        for (const std::string& text : {std::string(), std::string("abc"), std::string("abcdefghijklm"), noise}) {
+            auto [size, unpacked] = roundTrip(text);
+            REQUIRE(size != 0);
+            REQUIRE(size <= CompressBound(text.size()));
+            REQUIRE(unpacked == text);
+        }
+    }
+
+    SECTION("repetitive text → compressed several times, round trip", "[functional_requirements]") {
+        std::string text;
+        for (int i = 0; i != 2000; ++i) text += "2023-06-01 12:00:" + std::to_string(i % 60) + " [INFO] request served\n";
+
+        auto [size, unpacked] = roundTrip(text);
+        REQUIRE(size * 5 < text.size());
+        REQUIRE(unpacked == text);
+
+        auto [run_size, run] = roundTrip(std::string(100000, 'x'));
+        REQUIRE(run_size < 1000);
+        REQUIRE(run == std::string(100000, 'x'));
+    }
+
+    SECTION("too small output or corrupted input → 0 or exception", "[exceptions]") {
+        std::string text(1000, 'a');
+        std::vector<char> tiny(4);
+        REQUIRE(Block::Compress(text, tiny) == 0);
+
+        std::vector<char> packed(CompressBound(text.size()));
+        auto size = Block::Compress(text, packed);
+        std::vector<char> out(text.size());
+        REQUIRE_THROWS_AS(Block::Decompress(std::span<const char>(packed.data(), size), std::span<char>(out.data(), 10)), std::invalid_argument);
+
+        const std::vector<char> bad_offset = {0x10, 'a', 0x05, 0x00};
+        REQUIRE_THROWS_AS(Block::Decompress(bad_offset, out), std::invalid_argument);
+    }
+
+}
+
+TEST_CASE("Frame", "[libs][standard][compression][Frame]")
+{
+    using hlibs::standard::compression::Frame;
+    using hlibs::io::FileWriter;
+    using hlibs::io::FileLoader;
+    using hlibs::io::FileReader;
+    using hlibs::io::GetFileSize;
+
+    SECTION("compressing FileWriter on threads → smaller file, FileLoader and FileReader decompress", "[use_case]") {
+        const std::filesystem::path path("../../outputs/compression-frame-1-lines.hlz");
+        constexpr int count = 20000;
+        std::string expected;
+
+        {
+            FileWriter writer(path, std::ios::trunc, Frame{1UL << 14, 4});
+
+            for (int i = 0; i != count; ++i) {
+                auto line = "line " + std::to_string(i) + " of the compressed file\n";
+                writer.write(line);
+                expected += line;
+            }
+
+            REQUIRE(writer.bytes() == expected.size());
+            REQUIRE_THROWS_AS(writer.position(), std::logic_error);
+        }
+
+        REQUIRE(static_cast<std::size_t>(GetFileSize(path)) * 3 < expected.size());
+
+        FileLoader loader(path);
+        loader.read();
+        REQUIRE(std::string(loader.data().begin(), loader.data().end()) == expected);
+
+        FileReader reader(path);
+        std::string last;
+        while (reader.hasNextLine()) last = reader.getNextLine();
+        REQUIRE(reader.lines() == count);
+        REQUIRE(last == "line 19999 of the compressed file");
+    }
+
+    SECTION("append to compressed file → concatenated frames read as one", "[functional_requirements]") {
+        const std::filesystem::path path("../../outputs/compression-frame-2-append.hlz");
+
+        {
+            FileWriter writer(path, std::ios::trunc, Frame{});
+            writer.write("first\n");
+        }
+
+        {
+            FileWriter writer(path, std::ios::app, Frame{});
+            writer.write("second\n");
+            writer.sync();
+            writer.write("third\n");
+        }
+
+        FileLoader loader(path);
+        loader.read();
+        REQUIRE_THAT(std::string(loader.data().begin(), loader.data().end()), Catch::Matchers::Equals("first\nsecond\nthird\n"));
+    }
+
+    SECTION("corrupted block header → exception from FileLoader and FileReader, no huge allocation", "[exceptions]") {
+        const std::filesystem::path path("../../outputs/compression-frame-3-corrupted.hlz");
+
+        {
+            FileWriter writer(path, std::ios::trunc, Frame{1UL << 12});
+            for (int i = 0; i != 1000; ++i) writer.write("line of a file to be corrupted\n");
+        }
+
+        {
+            std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+            file.seekp(12);
+            file.write("\xFF\xFF\xFF\x7F", 4);     // raw size of the first block: 2 GiB
+        }
+
+        FileLoader loader(path);
+        REQUIRE_THROWS_AS(loader.read(), std::invalid_argument);
+
+        FileReader reader(path);
+        REQUIRE_THROWS_AS(reader.getNextLine(), std::invalid_argument);
+    }
+
+}
@@ -0,0 +1,81 @@
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+#include "../../sources/standard/utf8.hpp"
+#include "../../sources/io/helper_objects.hpp"
+
+
+TEST_CASE("FindInvalid", "[libs][standard][utf8][FindInvalid]")
+{
+    using hlibs::standard::utf8::FindInvalid;
+    using hlibs::standard::utf8::IsValid;
+    using hlibs::io::FileLoader;
+
+    SECTION("loaded multilingual file → valid", "[use_case]") {
+        FileLoader loader("../../inputs/utf8-1-text.txt");
+        loader.read();
+        REQUIRE(IsValid(loader.data()));
+    }
+
+    SECTION("malformed sequences → position of the first one", "[functional_requirements]") {
+        const std::string prefix(40, 'a');
+
+        REQUIRE(FindInvalid(prefix + "\x80") == 40);                  // lone continuation
+        REQUIRE(FindInvalid(prefix + "\xC0\xAF") == 40);              // overlong 2-byte
+        REQUIRE(FindInvalid(prefix + "\xE0\x80\xAF") == 40);          // overlong 3-byte
+        REQUIRE(FindInvalid(prefix + "\xED\xA0\x80") == 40);          // surrogate
+        REQUIRE(FindInvalid(prefix + "\xF4\x90\x80\x80") == 40);      // beyond U+10FFFF
+        REQUIRE(FindInvalid(prefix + "\xE2\x82") == 40);              // truncated at the end
+        REQUIRE(FindInvalid("\xC4\x85" + prefix + "\xC4") == 42);
+        REQUIRE(FindInvalid(std::string(31, 'b') + "\xF0\x9F\x98\x80" + prefix) == std::string::npos);
+    }
+
+    SECTION("empty and ASCII → valid", "[basic_check]") {
+        REQUIRE(IsValid(""));
+        REQUIRE(IsValid(std::string(1000, 'x')));
+        REQUIRE(!IsValid(std::string(1000, 'x') + '\xFF'));
+    }
+
+}
+
+TEST_CASE("Transcoding", "[libs][standard][utf8][Transcoding]")
+{
+    using namespace hlibs::standard::utf8;
+    using hlibs::io::FileLoader;
+
+    SECTION("loaded text → code points, UTF-16 units, round trips", "[functional_requirements]") {
+        FileLoader loader("../../inputs/utf8-1-text.txt");
+        loader.read();
+        const std::string text(loader.data().begin(), loader.data().end());
+
+        auto utf32 = ToUTF32(loader.data());
+        auto utf16 = ToUTF16(text);
+
+        REQUIRE(text.size() == 143);
+        REQUIRE(CountCodePoints(loader.data()) == 93);
+        REQUIRE(utf32.size() == 93);
+        REQUIRE(UTF16Length(text) == 94);
+        REQUIRE(utf16.size() == 94);
+        REQUIRE(utf32.back() == U'\n');
+        REQUIRE(utf32[utf32.size() - 2] == U'\U0001F600');
+        REQUIRE(FromUTF32(utf32) == text);
+        REQUIRE(FromUTF16(utf16) == text);
+    }
+
+    SECTION("caller buffer → filled without allocating, too small throws", "[basic_check]") {
+        const std::string_view text = "gęś";
+        std::vector<char32_t> buffer(3);
+
+        REQUIRE(ToUTF32(text, buffer) == 3);
+        REQUIRE(buffer == std::vector<char32_t>{U'g', U'ę', U'ś'});
+        REQUIRE_THROWS_AS(ToUTF32(text, std::span<char32_t>(buffer.data(), 2)), std::length_error);
+    }
+
+    SECTION("malformed input or code points → exception", "[exceptions]") {
+        REQUIRE_THROWS_AS(ToUTF32("abc\xC3"), std::invalid_argument);
+        REQUIRE_THROWS_AS(FromUTF32(std::u32string(1, char32_t(0xD800))), std::invalid_argument);
+        REQUIRE_THROWS_AS(FromUTF16(std::u16string(1, char16_t(0xDC00))), std::invalid_argument);
+    }
+
+}